@@ -2,6 +2,7 @@
 
 #include <SDL.h>
 
+#include <cstdint>
 #include <string_view>
 
 #include "engine/color.h"
@@ -17,8 +18,60 @@ constexpr int ScreenHeight = 720;
 // TODO: add camera scale instead of doing this
 constexpr int UnitSize = 50;
 
+// Size (in pixels) of each cached texture in the static render layer
+constexpr int StaticLayerChunkSize = 512;
+
+// Size (in pixels) of each cell in the grid used for culling renderables
+constexpr int RenderableGridCellSize = 128;
+
+// Size (in tiles) of the chunks levels are streamed in by (see 'tilemap.h')
+constexpr int LevelChunkSize = 16;
+// Chunks within this many of the camera's chunk are loaded
+constexpr int LevelStreamRadius = 2;
+// Extra chunks beyond the radius loaded chunks are kept for
+constexpr int LevelUnloadMargin = 1;
+
+// Initial size (in bytes) of the arena level entities + components live in
+constexpr size_t WorldArenaCapacity = 256 * 1024;
+
+// Number of events kept per thread by the profiler (if enabled)
+constexpr uint64_t ProfilerEventsPerThread = 1 << 18;
+
+// Number of frames of stage timings dumped when a frame exceeds its budget
+constexpr uint64_t HitchHistoryFrames = 120;
+
+// Number of frames excluded from the per frame allocation stats (if tracking)
+constexpr uint64_t AllocWarmupFrames = 120;
+
 constexpr double FixedTimeStep = 1.0 / 60.0;
 constexpr int PhysicsIterations = 4;
+// Most fixed ticks simulated in a single frame, any more are dropped
+constexpr int MaxFixedTicks = 4;
+
+// Number of key events which can be queued between frames (a power of 2)
+constexpr size_t InputEventQueueSize = 256;
+
+// Frame pacing without vsync (see 'frame_pacer.h'), times are in milliseconds
+constexpr double PacingSpinTime = 0.5;
+// Extra time allowed for just-in-time frames to be presented by their deadline
+constexpr double PacingMargin = 0.5;
+// Number of recent frames the just-in-time cost prediction is taken from
+constexpr int PacingCostWindow = 32;
+
+// Frame governor (see 'frame_governor.h'), loads are the fraction of the frame
+// budget the simulation thread spends working
+constexpr double GovernorSmoothing = 0.1;
+constexpr double GovernorHighLoad = 0.9;
+constexpr double GovernorLowLoad = 0.6;
+// Consecutive frames above/below the loads before stepping up/down a level
+constexpr int GovernorEngageFrames = 30;
+constexpr int GovernorReleaseFrames = 300;
+// Fixed ticks between off-screen AI updates when degraded
+constexpr int OffscreenAITickInterval = 4;
+
+// Cells around the player which enemies path find within (see
+// 'flow_field.h'), beyond it they head straight for the player
+constexpr int FlowFieldRadius = 32;
 
 constexpr int GameComponentIdOffset = 100;
 };	// namespace Config
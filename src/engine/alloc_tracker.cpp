@@ -0,0 +1,188 @@
+#include "engine/alloc_tracker.h"
+
+#ifdef ENABLE_ALLOC_TRACKING
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+
+#include "config.h"
+#include "engine/engine.h"
+#include "engine/types/histogram.h"
+
+// Nothing within here may allocate (eg. no std::string, std::vector, std::map
+// or locks which could), as it's all reachable from 'operator new'
+
+namespace AllocTracker {
+
+static constexpr int MaxTags = 32;
+
+struct Counts {
+	std::atomic<uint64_t> allocations;
+	std::atomic<uint64_t> bytes;
+};
+
+static Counts s_Stages[EngineStageCount];
+
+// Tag 0 is untagged
+static std::atomic<const char*> s_TagNames[MaxTags];
+static Counts s_Tags[MaxTags];
+
+static std::atomic<uint64_t> s_Allocations(0);
+static std::atomic<uint64_t> s_Frees(0);
+static std::atomic<int64_t> s_LiveBytes(0);
+static std::atomic<int64_t> s_PeakLiveBytes(0);
+
+static thread_local int t_Stage = 0;
+static thread_local int t_Tag = 0;
+
+// Simulation thread only
+static uint64_t s_Frame = 0;
+static uint64_t s_FrameStartAllocations = 0;
+static uint64_t s_MaxFrameAllocations = 0;
+static uint64_t s_MaxFrameAllocationsFrame = 0;
+static Histogram* s_FrameAllocations = nullptr;
+
+// Stored before each allocation, keeping the returned memory suitably aligned
+static constexpr size_t HeaderSize = alignof(std::max_align_t);
+
+static void* Allocate(size_t size) {
+	void* block = std::malloc(size + HeaderSize);
+	if (block == nullptr) return nullptr;
+
+	*(size_t*)block = size;
+
+	s_Allocations.fetch_add(1, std::memory_order_relaxed);
+	s_Stages[t_Stage].allocations.fetch_add(1, std::memory_order_relaxed);
+	s_Stages[t_Stage].bytes.fetch_add(size, std::memory_order_relaxed);
+	s_Tags[t_Tag].allocations.fetch_add(1, std::memory_order_relaxed);
+	s_Tags[t_Tag].bytes.fetch_add(size, std::memory_order_relaxed);
+
+	int64_t live =
+		s_LiveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+	int64_t peak = s_PeakLiveBytes.load(std::memory_order_relaxed);
+	while (live > peak && !s_PeakLiveBytes.compare_exchange_weak(
+							  peak, live, std::memory_order_relaxed)) {
+	}
+
+	return (std::byte*)block + HeaderSize;
+}
+
+static void Free(void* pointer) {
+	if (pointer == nullptr) return;
+
+	void* block = (std::byte*)pointer - HeaderSize;
+
+	s_Frees.fetch_add(1, std::memory_order_relaxed);
+	s_LiveBytes.fetch_sub(*(size_t*)block, std::memory_order_relaxed);
+
+	std::free(block);
+}
+
+static int FindOrAddTag(const char* tag) {
+	for (int i = 1; i < MaxTags; ++i) {
+		const char* name = s_TagNames[i].load(std::memory_order_acquire);
+		if (name == tag) return i;
+
+		if (name == nullptr) {
+			// Claim the empty slot, unless another thread just did
+			if (s_TagNames[i].compare_exchange_strong(name, tag)) return i;
+			if (name == tag) return i;
+		}
+	}
+
+	// Out of tags, count as untagged
+	return 0;
+}
+
+void SetStage(int stage) { t_Stage = stage; }
+
+void BeginFrame() {
+	s_FrameStartAllocations = s_Allocations.load(std::memory_order_relaxed);
+}
+
+void EndFrame() {
+	uint64_t allocations =
+		s_Allocations.load(std::memory_order_relaxed) - s_FrameStartAllocations;
+
+	if (s_Frame >= Config::AllocWarmupFrames) {
+		// Created lazily (and never freed) as it's too big to be static
+		if (s_FrameAllocations == nullptr) s_FrameAllocations = new Histogram();
+		s_FrameAllocations->Record(allocations);
+
+		if (allocations > s_MaxFrameAllocations) {
+			s_MaxFrameAllocations = allocations;
+			s_MaxFrameAllocationsFrame = s_Frame;
+		}
+	}
+
+	s_Frame++;
+}
+
+uint64_t GetMaxFrameAllocations(uint64_t* frame) {
+	if (frame != nullptr) *frame = s_MaxFrameAllocationsFrame;
+	return s_MaxFrameAllocations;
+}
+
+void Report(std::ostream& stream) {
+	auto reportCounts = [&stream](const char* name, const Counts& counts) {
+		uint64_t allocations = counts.allocations.load();
+		if (allocations == 0) return;
+
+		stream << "  " << std::left << std::setw(24) << name << std::right
+			   << std::setw(12) << allocations << std::setw(16)
+			   << counts.bytes.load() << std::endl;
+	};
+
+	stream << "[Allocations]: " << s_Allocations.load() << " allocations, "
+		   << s_Frees.load() << " frees, " << s_LiveBytes.load()
+		   << " live bytes (peak " << s_PeakLiveBytes.load() << ")"
+		   << std::endl;
+
+	if (s_FrameAllocations != nullptr) {
+		stream << "  Per steady state frame (after "
+			   << Config::AllocWarmupFrames
+			   << " frames): p50 " << s_FrameAllocations->GetPercentile(50)
+			   << "  p99 " << s_FrameAllocations->GetPercentile(99)
+			   << "  max " << s_MaxFrameAllocations << " (frame "
+			   << s_MaxFrameAllocationsFrame << ")" << std::endl;
+	}
+
+	stream << "  " << std::left << std::setw(24) << "Stage / Tag" << std::right
+		   << std::setw(12) << "Allocations" << std::setw(16) << "Bytes"
+		   << std::endl;
+	for (int stage = 0; stage < EngineStageCount; ++stage) {
+		reportCounts(GetEngineStageName((EngineStage)stage), s_Stages[stage]);
+	}
+
+	reportCounts("(untagged)", s_Tags[0]);
+	for (int tag = 1; tag < MaxTags; ++tag) {
+		const char* name = s_TagNames[tag].load();
+		if (name == nullptr) break;
+		reportCounts(name, s_Tags[tag]);
+	}
+}
+
+}  // namespace AllocTracker
+
+AllocScope::AllocScope(const char* tag) : m_PreviousTag(AllocTracker::t_Tag) {
+	AllocTracker::t_Tag = AllocTracker::FindOrAddTag(tag);
+}
+
+AllocScope::~AllocScope() { AllocTracker::t_Tag = m_PreviousTag; }
+
+// Replacing these also covers the array, nothrow and sized variants, which by
+// default forward to them. The aligned variants are left to pair up with each
+// other and aren't tracked.
+
+void* operator new(size_t size) {
+	void* pointer = AllocTracker::Allocate(size);
+	if (pointer == nullptr) throw std::bad_alloc();
+	return pointer;
+}
+
+void operator delete(void* pointer) noexcept { AllocTracker::Free(pointer); }
+
+#endif
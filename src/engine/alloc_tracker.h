@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+
+// Tracks every heap allocation (by replacing the global 'operator new' and
+// 'operator delete'), compiled out entirely unless ENABLE_ALLOC_TRACKING is
+// defined (eg. 'cmake -DENABLE_ALLOC_TRACKING=ON'). Allocations are counted
+// along with their bytes + the live bytes, tagged by the engine stage the
+// allocating thread is in and the innermost 'ALLOC_SCOPE' tag (if any).
+//
+// Frames are delimited by the simulation thread, so the allocations of a frame
+// also include any made by the main thread whilst it was being simulated. The
+// first 'Config::AllocWarmupFrames' frames are excluded from the per frame
+// stats, so they reflect the steady state.
+//
+// Tags aren't copied, so must outlive the tracker (eg. string literals).
+
+#ifdef ENABLE_ALLOC_TRACKING
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+
+#define ALLOC_SCOPE(tag) AllocScope ALLOC_CONCAT(allocScope, __LINE__)(tag)
+
+namespace AllocTracker {
+// Tags the calling thread's allocations with the engine stage
+void SetStage(int stage);
+
+void BeginFrame();
+void EndFrame();
+
+// Gets the most allocations made by a steady state frame so far
+uint64_t GetMaxFrameAllocations(uint64_t* frame = nullptr);
+
+void Report(std::ostream& stream);
+}  // namespace AllocTracker
+
+class AllocScope {
+   public:
+	AllocScope(const char* tag);
+	~AllocScope();
+
+   private:
+	int m_PreviousTag;
+};
+
+#else
+
+#define ALLOC_SCOPE(tag)
+
+#endif
@@ -34,6 +34,11 @@ inline static SDL_Color SetAlpha(SDL_Color color, uint8_t alpha) {
 	return {color.r, color.g, color.b, alpha};
 }
 
+inline static uint32_t ToUint32(SDL_Color color) {
+	return (uint32_t)color.r << 24 | (uint32_t)color.g << 16 |
+		   (uint32_t)color.b << 8 | (uint32_t)color.a;
+}
+
 inline static SDL_Color Lerp(SDL_Color a, SDL_Color b, float t) {
 	return {(uint8_t)MathUtils::Lerp(a.r, b.r, t),
 			(uint8_t)MathUtils::Lerp(a.g, b.g, t),
@@ -3,12 +3,19 @@
 #include "engine/engine.h"
 #include "engine/entity.h"
 
-const ComponentType EngineComponentType::Camera = EngineComponentType(1);
-const ComponentType EngineComponentType::StaticBody = EngineComponentType(10);
-const ComponentType EngineComponentType::RigidBody = EngineComponentType(11);
-const ComponentType EngineComponentType::RenderRect = EngineComponentType(20);
-
-Component::Component(ComponentType type) : m_Type(type), m_Active(true) {}
+const ComponentType EngineComponentType::Camera =
+	EngineComponentType(1, "Camera");
+const ComponentType EngineComponentType::StaticBody =
+	EngineComponentType(10, "StaticBody");
+const ComponentType EngineComponentType::RigidBody =
+	EngineComponentType(11, "RigidBody");
+const ComponentType EngineComponentType::RenderRect =
+	EngineComponentType(20, "RenderRect");
+const ComponentType EngineComponentType::TileMap =
+	EngineComponentType(21, "TileMap");
+
+Component::Component(ComponentType type)
+	: m_Type(type), m_Active(true), m_IsSetup(false), m_Entity(nullptr) {}
 
 void Component::SetActive(bool value) {
 	if (m_Active == value) return;
@@ -38,4 +45,6 @@ void Component::PostUpdate() {}
 
 void Component::Render() {}
 
-void Component::OnHit(Hit* hit) {}
\ No newline at end of file
+void Component::OnHit(Hit* hit) {}
+
+void Component::HashState(StateHash& hash) const {}
\ No newline at end of file
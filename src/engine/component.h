@@ -9,6 +9,7 @@ class Engine;
 struct Entity;
 struct AABB;
 struct Hit;
+class StateHash;
 
 // Enum-like struct since you can't inherit from an enum. This allows me to add
 // components specific to the game from outside the engine section of the
@@ -19,16 +20,20 @@ struct ComponentType {
    public:
 	operator int() const { return m_Id; }
 
+	// Used for debugging + profiling
+	inline const char* GetName() const { return m_Name; }
+
    protected:
-	ComponentType(int id) : m_Id(id) {}
+	ComponentType(int id, const char* name) : m_Id(id), m_Name(name) {}
 
    private:
 	int m_Id;
+	const char* m_Name;
 };
 
 class EngineComponentType : public ComponentType {
    private:
-	EngineComponentType(int id) : ComponentType(id) {
+	EngineComponentType(int id, const char* name) : ComponentType(id, name) {
 		// Ensure there is separation between engine and game components
 		ASSERT(id < Config::GameComponentIdOffset);
 	}
@@ -38,6 +43,7 @@ class EngineComponentType : public ComponentType {
 	static const ComponentType StaticBody;
 	static const ComponentType RigidBody;
 	static const ComponentType RenderRect;
+	static const ComponentType TileMap;
 };
 
 // Base Component that is added to entities to modify their behavior in various
@@ -52,7 +58,7 @@ class Component {
 	inline bool IsActive() const { return m_Active; }
 	void SetActive(bool value);
 
-	inline std::shared_ptr<Entity> GetEntity() const { return m_Entity; }
+	inline Entity* GetEntity() const { return m_Entity; }
 
    protected:
 	virtual void Setup();
@@ -73,6 +79,10 @@ class Component {
 
 	virtual void OnHit(Hit* hit);
 
+	// Adds any simulation state (that isn't already part of the entity) to the
+	// per tick state hash, see 'state_hash.h'
+	virtual void HashState(StateHash& hash) const;
+
    protected:
 	friend class Entity;
 
@@ -80,5 +90,6 @@ class Component {
 	bool m_Active;
 	bool m_IsSetup;
 
-	std::shared_ptr<Entity> m_Entity;
+	// Not owning, as the entity owns its components
+	Entity* m_Entity;
 };
\ No newline at end of file
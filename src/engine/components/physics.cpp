@@ -5,6 +5,7 @@
 #include "engine/engine.h"
 #include "engine/entity.h"
 #include "engine/physics.h"
+#include "engine/state_hash.h"
 
 Body::Body(ComponentType type, uint8_t collisionLayer)
 	: Component(type), collisionLayer(collisionLayer) {}
@@ -16,3 +17,5 @@ RigidBody::RigidBody(uint8_t collisionLayer, uint8_t collisionMask)
 	: Body(EngineComponentType::RigidBody, collisionLayer),
 	  vel(Vec2()),
 	  collisionMask(collisionMask) {}
+
+void RigidBody::HashState(StateHash& hash) const { hash.Add(vel); }
@@ -26,6 +26,8 @@ class RigidBody : public Body {
 	RigidBody(uint8_t collisionLayer = 0b00000001,
 			  uint8_t collisionMask = 0b11111111);
 
+	void HashState(StateHash& hash) const override;
+
    public:
 	Vec2 vel;
 	uint8_t collisionMask;
@@ -18,71 +18,108 @@ Renderable::Renderable(ComponentType type, RenderMode renderMode,
 	  renderMode(renderMode),
 	  fillColor(fillColor),
 	  outlineColor(outlineColor),
-	  order(order) {}
+	  order(order),
+	  m_IsInStaticLayer(false),
+	  m_GridIndex(-1) {}
 
 void Renderable::Render() {
 	if (renderMode == RenderMode::None) return;
 
-	if (renderMode != RenderMode::OutlineOnly) {
-		RenderFill();
+	// Drawn via the static layer instead
+	if (m_IsInStaticLayer) return;
+
+	RenderView(Engine::Instance()->GetCamera()->GetEntity()->visualAABB);
+}
+
+void Renderable::OnActivate() {
+	if (m_IsInStaticLayer || m_GridIndex != -1) return;
+
+	if (GetEntity()->IsStatic()) {
+		m_IsInStaticLayer = true;
+		m_LastStaticState = GetStaticState();
+		Engine::Instance()->GetStaticLayer()->Add(this);
+	} else {
+		Engine::Instance()->GetRenderableGrid()->Insert(this);
 	}
-	if (renderMode != RenderMode::FillOnly) {
-		RenderOutline();
+}
+
+void Renderable::OnDeactivate() {
+	if (m_IsInStaticLayer) {
+		m_IsInStaticLayer = false;
+		Engine::Instance()->GetStaticLayer()->Remove(this);
+	} else if (m_GridIndex != -1) {
+		Engine::Instance()->GetRenderableGrid()->Remove(this);
 	}
 }
 
-RenderRect::RenderRect(RenderMode renderMode, SDL_Color fillColor,
-					   SDL_Color outlineColor, int order)
-	: Renderable(EngineComponentType::RenderRect, renderMode, fillColor,
-				 outlineColor, order) {}
+void Renderable::Cleanup() { OnDeactivate(); }
 
-void RenderRect::RenderFill() const {
-	AABB* camAABB = &Engine::Instance()->GetCamera()->GetEntity()->visualAABB;
+bool Renderable::HasStaticStateChanged() {
+	StaticState state = GetStaticState();
 
-	AABB aabb = GetEntity()->visualAABB;
+	auto colorsEqual = [](SDL_Color a, SDL_Color b) {
+		return Color::ToUint32(a) == Color::ToUint32(b);
+	};
 
-	// Check if this can be culled
-	if (!AABB::CheckIntersection(&aabb, camAABB)) return;
+	bool hasChanged =
+		state.renderMode != m_LastStaticState.renderMode ||
+		!colorsEqual(state.fillColor, m_LastStaticState.fillColor) ||
+		!colorsEqual(state.outlineColor, m_LastStaticState.outlineColor) ||
+		state.order != m_LastStaticState.order ||
+		state.aabb.pos != m_LastStaticState.aabb.pos ||
+		state.aabb.halfSize != m_LastStaticState.aabb.halfSize;
 
-	Vec2 camOffset = camAABB->pos - camAABB->halfSize;
-	aabb.pos -= camOffset;
+	m_LastStaticState = state;
+	return hasChanged;
+}
 
-	Engine::Instance()->AddRenderOp(
-		std::dynamic_pointer_cast<RenderOp>(std::make_shared<RenderOpRectFill>(
-			(SDL_FRect){aabb.pos.x - aabb.halfSize.x,
-						aabb.pos.y - aabb.halfSize.y, aabb.halfSize.x * 2,
-						aabb.halfSize.y * 2},
-			fillColor, order)));
+void Renderable::InvalidateStaticRegion(const SDL_FRect& region) const {
+	if (m_IsInStaticLayer) {
+		Engine::Instance()->GetStaticLayer()->Invalidate(region);
+	}
 }
 
-void RenderRect::RenderOutline() const {
-	AABB* camAABB = &Engine::Instance()->GetCamera()->GetEntity()->visualAABB;
+Renderable::StaticState Renderable::GetStaticState() const {
+	return {renderMode, fillColor, outlineColor, order, GetEntity()->aabb};
+}
 
-	AABB aabb = GetEntity()->visualAABB;
+RenderRect::RenderRect(RenderMode renderMode, SDL_Color fillColor,
+					   SDL_Color outlineColor, int order)
+	: Renderable(EngineComponentType::RenderRect, renderMode, fillColor,
+				 outlineColor, order) {}
+
+void RenderRect::RenderView(const AABB& view) const {
+	Vec2 min, max;
+	GetEntity()->visualAABB.GetMinMax(min, max);
 
-	// Check if this can be culled
-	if (!AABB::CheckIntersection(&aabb, camAABB)) return;
+	Vec2 camOffset = view.pos - view.halfSize;
+	min -= camOffset;
+	max -= camOffset;
+
+	SDL_FRect rect = {min.x, min.y, max.x - min.x, max.y - min.y};
+
+	if (renderMode != RenderMode::OutlineOnly) {
+		Engine::Instance()->AddRenderOp(
+			RenderOp::RectFill(rect, fillColor, order));
+	}
+	if (renderMode != RenderMode::FillOnly &&
+		!Engine::Instance()->IsDegraded(DegradationLevel::NoOutlines)) {
+		Engine::Instance()->AddRenderOp(
+			RenderOp::RectOutline(rect, outlineColor, order));
+	}
+}
 
-	Vec2 camOffset = camAABB->pos - camAABB->halfSize;
-	aabb.pos -= camOffset;
+void RenderRect::RenderStatic(std::vector<RenderOp>& ops) const {
+	if (renderMode == RenderMode::None) return;
 
 	Vec2 min, max;
-	aabb.GetMinMax(min, max);
-
-	max -= 1.0;
-
-	std::shared_ptr<SDL_FPoint[]> points(new SDL_FPoint[5]);
-	points[0].x = min.x;
-	points[0].y = min.y;
-	points[1].x = max.x;
-	points[1].y = min.y;
-	points[2].x = max.x;
-	points[2].y = max.y;
-	points[3].x = min.x;
-	points[3].y = max.y;
-	points[4].x = min.x;
-	points[4].y = min.y;
-
-	Engine::Instance()->AddRenderOp(std::dynamic_pointer_cast<RenderOp>(
-		std::make_shared<RenderOpRectOutline>(points, outlineColor, order)));
+	GetEntity()->aabb.GetMinMax(min, max);
+	SDL_FRect rect = {min.x, min.y, max.x - min.x, max.y - min.y};
+
+	if (renderMode != RenderMode::OutlineOnly) {
+		ops.push_back(RenderOp::RectFill(rect, fillColor, order));
+	}
+	if (renderMode != RenderMode::FillOnly) {
+		ops.push_back(RenderOp::RectOutline(rect, outlineColor, order));
+	}
 }
\ No newline at end of file
@@ -2,7 +2,11 @@
 
 #include <SDL.h>
 
+#include <vector>
+
 #include "engine/component.h"
+#include "engine/physics.h"
+#include "engine/renderop.h"
 
 enum class RenderMode {
 	None,
@@ -21,8 +25,24 @@ class Renderable : public Component {
 	void Render() override;
 
    protected:
-	virtual void RenderFill() const = 0;
-	virtual void RenderOutline() const = 0;
+	void OnActivate() override;
+	void OnDeactivate() override;
+	void Cleanup() override;
+
+	// Submits render ops offset by the camera's view, which this is already
+	// known to be overlapping (via the engine's renderable grid)
+	virtual void RenderView(const AABB& view) const = 0;
+
+	// Renderables on static entities are captured into the engine's static
+	// layer in world space, instead of being rendered every frame
+	virtual void RenderStatic(std::vector<RenderOp>& ops) const = 0;
+
+	// Compares against the state from when this was last checked
+	virtual bool HasStaticStateChanged();
+
+	// Recaptures the static layer, only redrawing the world space region (if
+	// this is in the static layer)
+	void InvalidateStaticRegion(const SDL_FRect& region) const;
 
    public:
 	RenderMode renderMode;
@@ -31,6 +51,26 @@ class Renderable : public Component {
 	SDL_Color outlineColor;
 
 	int order;
+
+   private:
+	friend class StaticLayer;
+	friend class RenderableGrid;
+
+	struct StaticState {
+		RenderMode renderMode;
+		SDL_Color fillColor;
+		SDL_Color outlineColor;
+		int order;
+		AABB aabb;
+	};
+
+	StaticState GetStaticState() const;
+
+	bool m_IsInStaticLayer;
+	StaticState m_LastStaticState;
+
+	// Index within the renderable grid, -1 if not in it
+	int m_GridIndex;
 };
 
 class RenderRect : public Renderable {
@@ -40,8 +80,9 @@ class RenderRect : public Renderable {
 			   SDL_Color outlineColor = Color::White, int order = 0);
 
    protected:
-	void RenderFill() const override;
-	void RenderOutline() const override;
+	void RenderView(const AABB& view) const override;
+
+	void RenderStatic(std::vector<RenderOp>& ops) const override;
 };
 
 // TODO: add rotate rect (via SDL_RenderGeometry())
\ No newline at end of file
@@ -0,0 +1,371 @@
+#include "engine/components/tilemap.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "engine/components/camera.h"
+#include "engine/engine.h"
+#include "engine/entity.h"
+#include "utils.h"
+
+TileMap::TileMap(int width, int height, float tileSize,
+				 std::vector<TileType> tileTypes, std::vector<uint8_t> tiles,
+				 int order)
+	: Renderable(EngineComponentType::TileMap, RenderMode::Both, Color::White,
+				 Color::White, order),
+	  m_Width(width),
+	  m_Height(height),
+	  m_TileSize(tileSize),
+	  m_TileTypes(std::move(tileTypes)),
+	  m_Tiles(std::move(tiles)),
+	  m_ChunkSize(Config::LevelChunkSize),
+	  m_ChunksX((width + m_ChunkSize - 1) / m_ChunkSize),
+	  m_ChunksY((height + m_ChunkSize - 1) / m_ChunkSize),
+	  m_LoadedChunkCount(0),
+	  m_HasColliders(false),
+	  m_TileRevision(0) {
+	ASSERT(m_Tiles.size() == (size_t)(width * height));
+	ASSERT(!m_TileTypes.empty());
+
+	m_Chunks.resize(m_ChunksX * m_ChunksY, {ChunkState::Unloaded, {}, {}});
+}
+
+void TileMap::SetTile(int x, int y, uint8_t tile) {
+	ASSERT(tile < m_TileTypes.size());
+
+	uint8_t& current = m_Tiles[y * m_Width + x];
+	if (current == tile) return;
+
+	// The worker could be reading the tiles
+	FinishLoading();
+
+	current = tile;
+	m_TileRevision++;
+
+	int index = (y / m_ChunkSize) * m_ChunksX + x / m_ChunkSize;
+	if (m_HasColliders) MergeChunkColliders(index);
+
+	// Requested again by the next update if it's still needed
+	if (m_Chunks[index].state == ChunkState::Loaded) UnloadChunk(index);
+}
+
+void TileMap::SetColliders(const std::vector<TileCollider>& colliders,
+						   const std::vector<uint32_t>& chunkOffsets) {
+	ASSERT(chunkOffsets.size() == m_Chunks.size() + 1);
+	ASSERT(chunkOffsets.back() == colliders.size());
+
+	// The worker never reads the colliders, but finish any load first so
+	// nothing is in flight whilst they're replaced
+	FinishLoading();
+
+	for (size_t i = 0; i < m_Chunks.size(); ++i) {
+		m_Chunks[i].colliders.assign(colliders.begin() + chunkOffsets[i],
+									 colliders.begin() + chunkOffsets[i + 1]);
+	}
+
+	m_HasColliders = true;
+}
+
+void TileMap::MergeColliders(int width, const std::vector<TileType>& tileTypes,
+							 const uint8_t* tiles, int minX, int minY,
+							 int maxX, int maxY,
+							 std::vector<TileCollider>& colliders) {
+	auto GetCollisionLayer = [&](int x, int y) {
+		return tileTypes[tiles[y * width + x]].collisionLayer;
+	};
+
+	// Cells within the range already covered by a collider
+	int rangeWidth = maxX - minX + 1;
+	std::vector<bool> merged(rangeWidth * (maxY - minY + 1), false);
+	auto IsMerged = [&](int x, int y) {
+		return merged[(y - minY) * rangeWidth + x - minX];
+	};
+
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			uint8_t layer = GetCollisionLayer(x, y);
+			if (layer == 0 || IsMerged(x, y)) continue;
+
+			// Grow right as far as possible, then down whilst every cell in
+			// the next row matches
+			int endX = x + 1;
+			while (endX <= maxX && GetCollisionLayer(endX, y) == layer &&
+				   !IsMerged(endX, y)) {
+				endX++;
+			}
+
+			int endY = y + 1;
+			for (; endY <= maxY; ++endY) {
+				bool rowMatches = true;
+				for (int i = x; i < endX && rowMatches; ++i) {
+					rowMatches = GetCollisionLayer(i, endY) == layer &&
+								 !IsMerged(i, endY);
+				}
+				if (!rowMatches) break;
+			}
+
+			for (int j = y; j < endY; ++j) {
+				for (int i = x; i < endX; ++i) {
+					merged[(j - minY) * rangeWidth + i - minX] = true;
+				}
+			}
+
+			colliders.push_back({(uint16_t)x, (uint16_t)y, (uint16_t)(endX - x),
+								 (uint16_t)(endY - y), layer});
+		}
+	}
+}
+
+Vec2 TileMap::GetOrigin() const {
+	return m_Entity->aabb.pos - Vec2(m_Width, m_Height) * m_TileSize / 2.0;
+}
+
+AABB TileMap::GetCellAABB(int x, int y) const {
+	float halfTileSize = m_TileSize / 2.0;
+	return {GetOrigin() + Vec2(x, y) * m_TileSize + halfTileSize,
+			Vec2(halfTileSize)};
+}
+
+AABB TileMap::GetColliderAABB(const TileCollider& collider) const {
+	Vec2 halfSize = Vec2(collider.width, collider.height) * m_TileSize / 2.0;
+	return {GetOrigin() + Vec2(collider.x, collider.y) * m_TileSize + halfSize,
+			halfSize};
+}
+
+bool TileMap::GetCellRange(Vec2 min, Vec2 max, int& minX, int& minY,
+						   int& maxX, int& maxY) const {
+	Vec2 origin = GetOrigin();
+	min = (min - origin) / m_TileSize;
+	max = (max - origin) / m_TileSize;
+
+	minX = std::max((int)floorf(min.x), 0);
+	minY = std::max((int)floorf(min.y), 0);
+	maxX = std::min((int)floorf(max.x), m_Width - 1);
+	maxY = std::min((int)floorf(max.y), m_Height - 1);
+
+	return minX <= maxX && minY <= maxY;
+}
+
+bool TileMap::CheckIntersection(AABB* aabb, uint8_t collisionMask) const {
+	Vec2 min, max;
+	aabb->GetMinMax(min, max);
+
+	int minX, minY, maxX, maxY;
+	if (!GetCellRange(min, max, minX, minY, maxX, maxY)) return false;
+
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			if ((GetCollisionLayer(x, y) & collisionMask) == 0) continue;
+
+			AABB cell = GetCellAABB(x, y);
+			if (AABB::CheckIntersection(&cell, aabb)) return true;
+		}
+	}
+
+	return false;
+}
+
+void TileMap::Setup() {
+	// Ensure this is the only tile map
+	ASSERT(Engine::Instance()->GetTileMap() == nullptr);
+
+	Engine::Instance()->SetTileMap(shared_from_this());
+
+	if (!m_HasColliders) {
+		for (size_t i = 0; i < m_Chunks.size(); ++i) MergeChunkColliders(i);
+		m_HasColliders = true;
+	}
+
+	// Start loading the chunks around the camera straight away
+	UpdateStreaming();
+}
+
+void TileMap::Cleanup() {
+	Renderable::Cleanup();
+
+	// The worker mustn't outlive the tiles
+	if (m_PendingLoad.valid()) m_PendingLoad.wait();
+
+	if (Engine::Instance()->GetTileMap().get() == this) {
+		Engine::Instance()->SetTileMap(nullptr);
+	}
+}
+
+void TileMap::RenderView(const AABB& view) const {
+	Vec2 min, max;
+	view.GetMinMax(min, max);
+
+	int minX, minY, maxX, maxY;
+	if (!GetCellRange(min, max, minX, minY, maxX, maxY)) return;
+
+	EmitTileOps(minX, minY, maxX, maxY, min,
+				renderMode != RenderMode::OutlineOnly,
+				renderMode != RenderMode::FillOnly, [](const RenderOp& op) {
+					Engine::Instance()->AddRenderOp(op);
+				});
+}
+
+void TileMap::RenderStatic(std::vector<RenderOp>& ops) const {
+	if (renderMode == RenderMode::None) return;
+
+	bool fills = renderMode != RenderMode::OutlineOnly;
+	bool outlines = renderMode != RenderMode::FillOnly;
+
+	for (const Chunk& chunk : m_Chunks) {
+		if (chunk.state != ChunkState::Loaded) continue;
+
+		for (const RenderOp& op : chunk.ops) {
+			if (op.type == RenderOpType::RectFill ? fills : outlines) {
+				ops.push_back(op);
+			}
+		}
+	}
+}
+
+void TileMap::PreFixedUpdate() { UpdateStreaming(); }
+
+void TileMap::UpdateStreaming() {
+	FinishLoading();
+
+	// Chunk the camera is in (or would be in, if it's off the map)
+	auto camera = Engine::Instance()->GetCamera();
+	Vec2 focus = camera != nullptr ? camera->GetEntity()->aabb.pos
+								   : m_Entity->aabb.pos;
+	Vec2 focusCell = (focus - GetOrigin()) / (m_TileSize * m_ChunkSize);
+	int focusX = (int)floorf(focusCell.x);
+	int focusY = (int)floorf(focusCell.y);
+
+	// Loaded chunks are kept until they're a margin beyond the radius, so
+	// moving back + forth across a chunk's edge doesn't keep reloading
+	constexpr int unloadRadius =
+		Config::LevelStreamRadius + Config::LevelUnloadMargin;
+	for (int y = 0; y < m_ChunksY; ++y) {
+		for (int x = 0; x < m_ChunksX; ++x) {
+			int index = y * m_ChunksX + x;
+			if (m_Chunks[index].state == ChunkState::Loaded &&
+				std::max(std::abs(x - focusX), std::abs(y - focusY)) >
+					unloadRadius) {
+				UnloadChunk(index);
+			}
+		}
+	}
+
+	std::vector<int> requests;
+	int minX = std::max(focusX - Config::LevelStreamRadius, 0);
+	int minY = std::max(focusY - Config::LevelStreamRadius, 0);
+	int maxX = std::min(focusX + Config::LevelStreamRadius, m_ChunksX - 1);
+	int maxY = std::min(focusY + Config::LevelStreamRadius, m_ChunksY - 1);
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			Chunk& chunk = m_Chunks[y * m_ChunksX + x];
+			if (chunk.state != ChunkState::Unloaded) continue;
+
+			chunk.state = ChunkState::Loading;
+			requests.push_back(y * m_ChunksX + x);
+		}
+	}
+
+	if (!requests.empty()) {
+		m_PendingLoad = std::async(std::launch::async, &TileMap::LoadChunks,
+								   this, std::move(requests));
+	}
+}
+
+void TileMap::FinishLoading() {
+	if (!m_PendingLoad.valid()) return;
+
+	for (LoadedChunk& loaded : m_PendingLoad.get()) {
+		Chunk& chunk = m_Chunks[loaded.index];
+		chunk.state = ChunkState::Loaded;
+		chunk.ops = std::move(loaded.ops);
+
+		m_LoadedChunkCount++;
+		InvalidateStaticRegion(GetChunkRect(loaded.index));
+	}
+}
+
+void TileMap::UnloadChunk(int index) {
+	Chunk& chunk = m_Chunks[index];
+	chunk.state = ChunkState::Unloaded;
+	// Release the memory, rather than just clearing
+	std::vector<RenderOp>().swap(chunk.ops);
+
+	m_LoadedChunkCount--;
+	InvalidateStaticRegion(GetChunkRect(index));
+}
+
+void TileMap::MergeChunkColliders(int index) {
+	int minX, minY, maxX, maxY;
+	GetChunkCellRange(index, minX, minY, maxX, maxY);
+
+	std::vector<TileCollider>& colliders = m_Chunks[index].colliders;
+	colliders.clear();
+	MergeColliders(m_Width, m_TileTypes, m_Tiles.data(), minX, minY, maxX,
+				   maxY, colliders);
+}
+
+void TileMap::GetChunkCellRange(int index, int& minX, int& minY, int& maxX,
+								int& maxY) const {
+	minX = (index % m_ChunksX) * m_ChunkSize;
+	minY = (index / m_ChunksX) * m_ChunkSize;
+	maxX = std::min(minX + m_ChunkSize, m_Width) - 1;
+	maxY = std::min(minY + m_ChunkSize, m_Height) - 1;
+}
+
+SDL_FRect TileMap::GetChunkRect(int index) const {
+	int minX, minY, maxX, maxY;
+	GetChunkCellRange(index, minX, minY, maxX, maxY);
+
+	Vec2 origin = GetOrigin();
+	return {origin.x + minX * m_TileSize, origin.y + minY * m_TileSize,
+			(maxX - minX + 1) * m_TileSize, (maxY - minY + 1) * m_TileSize};
+}
+
+std::vector<TileMap::LoadedChunk> TileMap::LoadChunks(
+	std::vector<int> indices) const {
+	std::vector<LoadedChunk> loadedChunks;
+	loadedChunks.reserve(indices.size());
+
+	for (int index : indices) {
+		LoadedChunk loaded = {index, {}};
+
+		int minX, minY, maxX, maxY;
+		GetChunkCellRange(index, minX, minY, maxX, maxY);
+
+		// Both, as the render mode is only applied when capturing
+		EmitTileOps(
+			minX, minY, maxX, maxY, Vec2(), true, true,
+			[&loaded](const RenderOp& op) { loaded.ops.push_back(op); });
+
+		loadedChunks.push_back(std::move(loaded));
+	}
+
+	return loadedChunks;
+}
+
+template <typename EmitFunc>
+void TileMap::EmitTileOps(int minX, int minY, int maxX, int maxY, Vec2 offset,
+						  bool fills, bool outlines, EmitFunc&& emit) const {
+	Vec2 origin = GetOrigin() - offset;
+
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			uint8_t tile = GetTile(x, y);
+			if (tile == EmptyTile) continue;
+
+			const TileType& type = m_TileTypes[tile];
+			if (type.renderMode == RenderMode::None) continue;
+
+			SDL_FRect rect = {origin.x + x * m_TileSize,
+							  origin.y + y * m_TileSize, m_TileSize,
+							  m_TileSize};
+
+			if (fills && type.renderMode != RenderMode::OutlineOnly) {
+				emit(RenderOp::RectFill(rect, type.fillColor, order));
+			}
+			if (outlines && type.renderMode != RenderMode::FillOnly) {
+				emit(RenderOp::RectOutline(rect, type.outlineColor, order));
+			}
+		}
+	}
+}
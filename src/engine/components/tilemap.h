@@ -0,0 +1,197 @@
+#pragma once
+
+#include <SDL.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <vector>
+
+#include "config.h"
+#include "engine/components/renderables.h"
+#include "engine/physics.h"
+
+// A grid of tiles stored as a compact byte per tile, indexing into a table of
+// tile types, rather than an entity per tile. Rendering only visits the tiles
+// within the camera's view and collision is answered by looking up the cells a
+// body overlaps. The grid is centered on the entity's position.
+//
+// The map is split into chunks of 'Config::LevelChunkSize' tiles, whose render
+// ops are streamed in around the camera, so the cost of drawing huge maps
+// doesn't grow with their size. A worker builds each loaded chunk's static
+// render ops, which are picked up at the start of the next fixed update (so
+// they arrive on the same tick every run) and only invalidate that chunk's
+// region of the static layer. Chunks further away are unloaded. Every chunk's
+// merged colliders stay resident, as they're small, so collision never depends
+// on what's loaded.
+
+struct TileType {
+	RenderMode renderMode;
+
+	SDL_Color fillColor;
+	SDL_Color outlineColor;
+
+	// Layer used when colliding with rigidbodies, 0 for no collision
+	uint8_t collisionLayer;
+};
+
+// A rectangle of cells (within a single chunk) which all collide on the same
+// layer, so they can be swept against at once without any internal seams
+struct TileCollider {
+	uint16_t x;
+	uint16_t y;
+	uint16_t width;
+	uint16_t height;
+
+	uint8_t collisionLayer;
+};
+
+class TileMap : public Renderable,
+				public std::enable_shared_from_this<TileMap> {
+   public:
+	// Tile type 0 is reserved for empty tiles
+	static constexpr uint8_t EmptyTile = 0;
+
+	TileMap(int width, int height, float tileSize,
+			std::vector<TileType> tileTypes, std::vector<uint8_t> tiles,
+			int order = 0);
+
+	inline int GetWidth() const { return m_Width; }
+	inline int GetHeight() const { return m_Height; }
+	inline float GetTileSize() const { return m_TileSize; }
+
+	inline uint8_t GetTile(int x, int y) const {
+		return m_Tiles[y * m_Width + x];
+	}
+	// Simulation thread, the tile's chunk has its colliders merged again and
+	// is reloaded if it was loaded
+	void SetTile(int x, int y, uint8_t tile);
+	// Incremented whenever a tile changes
+	inline uint32_t GetTileRevision() const { return m_TileRevision; }
+
+	inline const TileType& GetTileType(uint8_t tile) const {
+		return m_TileTypes[tile];
+	}
+
+	inline uint8_t GetCollisionLayer(int x, int y) const {
+		return m_TileTypes[GetTile(x, y)].collisionLayer;
+	}
+
+	Vec2 GetOrigin() const;
+	AABB GetCellAABB(int x, int y) const;
+
+	// Gets the range of cells overlapping the given world space bounds,
+	// returns false if none do
+	bool GetCellRange(Vec2 min, Vec2 max, int& minX, int& minY, int& maxX,
+					  int& maxY) const;
+
+	// Whether any colliding tile matching the mask overlaps 'aabb'
+	bool CheckIntersection(AABB* aabb, uint8_t collisionMask) const;
+
+	// Sets precomputed merged colliders (see 'LevelFile::MergeColliders()'),
+	// bucketed by chunk with 'chunkOffsets' being the start of each chunk's
+	// colliders (plus the end). Otherwise every chunk's colliders are merged
+	// during setup.
+	void SetColliders(const std::vector<TileCollider>& colliders,
+					  const std::vector<uint32_t>& chunkOffsets);
+
+	// Greedily merges the colliding tiles within the cell range (inclusive)
+	// into rectangles, without mixing collision layers
+	static void MergeColliders(int width,
+							   const std::vector<TileType>& tileTypes,
+							   const uint8_t* tiles, int minX, int minY,
+							   int maxX, int maxY,
+							   std::vector<TileCollider>& colliders);
+
+	// Visits the merged colliders of every chunk overlapping the cell range,
+	// as 'visit(const AABB& aabb, uint8_t collisionLayer)'
+	template <typename VisitFunc>
+	void VisitColliders(int minX, int minY, int maxX, int maxY,
+						VisitFunc&& visit) const {
+		for (int chunkY = minY / m_ChunkSize; chunkY <= maxY / m_ChunkSize;
+			 ++chunkY) {
+			for (int chunkX = minX / m_ChunkSize; chunkX <= maxX / m_ChunkSize;
+				 ++chunkX) {
+				const Chunk& chunk = m_Chunks[chunkY * m_ChunksX + chunkX];
+				for (const TileCollider& collider : chunk.colliders) {
+					visit(GetColliderAABB(collider), collider.collisionLayer);
+				}
+			}
+		}
+	}
+
+	AABB GetColliderAABB(const TileCollider& collider) const;
+
+	inline int GetLoadedChunkCount() const { return m_LoadedChunkCount; }
+
+   protected:
+	void Setup() override;
+	void Cleanup() override;
+
+	void PreFixedUpdate() override;
+
+	void RenderView(const AABB& view) const override;
+
+	void RenderStatic(std::vector<RenderOp>& ops) const override;
+
+   private:
+	enum class ChunkState {
+		Unloaded,
+		Loading,
+		Loaded,
+	};
+
+	struct Chunk {
+		ChunkState state;
+
+		// World space, with both the fills + outlines, only while loaded
+		std::vector<RenderOp> ops;
+		// Always resident
+		std::vector<TileCollider> colliders;
+	};
+
+	struct LoadedChunk {
+		int index;
+
+		std::vector<RenderOp> ops;
+	};
+
+	// Picks up the last requested chunks (waiting if they're still loading),
+	// then unloads/requests chunks based on the camera's position
+	void UpdateStreaming();
+	void FinishLoading();
+	void UnloadChunk(int index);
+
+	void MergeChunkColliders(int index);
+	void GetChunkCellRange(int index, int& minX, int& minY, int& maxX,
+						   int& maxY) const;
+	SDL_FRect GetChunkRect(int index) const;
+
+	// Worker
+	std::vector<LoadedChunk> LoadChunks(std::vector<int> indices) const;
+
+	template <typename EmitFunc>
+	void EmitTileOps(int minX, int minY, int maxX, int maxY, Vec2 offset,
+					 bool fills, bool outlines, EmitFunc&& emit) const;
+
+   private:
+	int m_Width;
+	int m_Height;
+	float m_TileSize;
+
+	// Read by the worker whilst loading, so only changed once it's finished
+	std::vector<TileType> m_TileTypes;
+	std::vector<uint8_t> m_Tiles;
+
+	int m_ChunkSize;
+	int m_ChunksX;
+	int m_ChunksY;
+	std::vector<Chunk> m_Chunks;
+	int m_LoadedChunkCount;
+	bool m_HasColliders;
+
+	std::future<std::vector<LoadedChunk>> m_PendingLoad;
+
+	uint32_t m_TileRevision;
+};
@@ -1,9 +1,14 @@
 #include "engine/engine.h"
 
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <string>
 
 #include "config.h"
+#include "engine/alloc_tracker.h"
+#include "engine/components/camera.h"
+#include "engine/entity.h"
 #include "engine/types/entity_collection.h"
 #include "mathutils.h"
 #include "utils.h"
@@ -12,10 +17,11 @@ Engine::Engine()
 	: running(true),
 	  m_ScheduledFixedUpdateTicks(true),
 	  doInterpolation(true),
-	  m_RenderingRenderBufferIndex(0),
-	  m_PreparingRenderBufferIndex(0),
 	  m_Stage(EngineStage::Idle),
-	  m_IsCleanedUp(false) {}
+	  m_IsCleanedUp(false),
+	  m_RenderOpCount(0),
+	  m_DrawCallCount(0),
+	  m_SimulationThreadState(EngineThreadState::Paused) {}
 
 Engine::~Engine() {
 	// Ensure engine cleans up properly
@@ -29,23 +35,126 @@ std::shared_ptr<Engine> Engine::Instance() {
 }
 
 int Engine::Setup(int argc, char* argv[]) {
-	m_Stage = EngineStage::Setup;
+	SetStage(EngineStage::Setup);
+
+	if (!EngineOptions::Parse(argc, argv, m_Options)) return 1;
+
+	// Only compares/converts files, so there's nothing else to setup
+	if (m_Options.IsHashDiff() || m_Options.IsLevelConversion()) {
+		SetStage(EngineStage::Idle);
+		return 0;
+	}
+
+	if (!m_Options.replayPath.empty()) {
+		m_InputPlayer = std::make_shared<InputPlayer>();
+		if (!m_InputPlayer->Open(m_Options.replayPath)) return 1;
+
+		m_Options.seed = m_InputPlayer->GetHeader().seed;
+		m_Options.levelPath = m_InputPlayer->GetHeader().levelPath;
+	}
+
+	MathUtils::SetRandomSeed(m_Options.seed);
 
 	int sdlSetupResult = SetupSDL();
 	if (sdlSetupResult > 0) return sdlSetupResult;
 
-	m_TimeState = std::make_shared<TimeState>(SDL_GetPerformanceCounter(),
-											  SDL_GetPerformanceFrequency(),
-											  Config::FixedTimeStep);
+	// Replays are always driven by the recorded clock
+	uint64_t perfFreq;
+	if (m_InputPlayer != nullptr) {
+		perfFreq = m_InputPlayer->GetHeader().perfFreq;
+		m_LastPerfCounter = 0;
+	} else if (m_Options.headless) {
+		perfFreq = m_VirtualPerfFreq;
+		m_LastPerfCounter = 0;
+	} else {
+		perfFreq = SDL_GetPerformanceFrequency();
+		m_LastPerfCounter = SDL_GetPerformanceCounter();
+	}
+
+	m_TimeState = std::make_shared<TimeState>(m_LastPerfCounter, perfFreq,
+											  Config::FixedTimeStep,
+											  Config::MaxFixedTicks);
+
+	if (!m_Options.recordPath.empty()) {
+		m_InputRecorder = std::make_shared<InputRecorder>();
+		if (!m_InputRecorder->Open(m_Options.recordPath,
+								   {m_Options.seed, perfFreq,
+									m_Options.levelPath})) {
+			return 1;
+		}
+	}
+
+	if (!m_Options.hashOutPath.empty()) {
+		m_StateHashRecorder = std::make_shared<StateHashRecorder>();
+		if (!m_StateHashRecorder->Open(m_Options.hashOutPath)) return 1;
+	}
 
 	m_Input = std::make_shared<Input>();
+	SDL_AddEventWatch(&Input::EventWatch, m_Input.get());
+	m_FrameStats = std::make_shared<FrameStats>(m_Options.frameBudget,
+												m_Options.hitchPath);
+
+	// Degrading changes the simulation + what's rendered, so is only done
+	// when nothing relies on the run being reproducible
+	if (!m_Options.headless && m_Options.recordPath.empty() &&
+		m_Options.replayPath.empty() && m_Options.hashOutPath.empty()) {
+		// Defaults to the target frame (or fixed tick) if no budget was given
+		double frameBudget = m_Options.frameBudget;
+		if (frameBudget <= 0.0) {
+			frameBudget = m_Options.pacing != PacingMode::VSync
+							  ? 1000.0 / m_Options.targetFps
+							  : Config::FixedTimeStep * 1000.0;
+		}
+
+		m_FrameGovernor = std::make_shared<FrameGovernor>(frameBudget);
+	}
+
+	if (!m_Options.headless && m_Options.pacing != PacingMode::VSync) {
+		m_FramePacer =
+			std::make_shared<FramePacer>(m_Options.pacing, m_Options.targetFps);
+	}
+
+	// Opened later by the thread running the simulation
+	if (m_Options.perfCounters) {
+		m_PerfCounters = std::make_shared<PerfCounters>(m_Options.perfCsvPath);
+	}
 
-	m_Stage = EngineStage::Idle;
+	m_StaticLayer = std::make_shared<StaticLayer>();
+	m_RenderableGrid =
+		std::make_shared<RenderableGrid>(Config::RenderableGridCellSize);
+	m_TransformSystem = std::make_shared<TransformSystem>();
+	m_WorldArena = std::make_shared<WorldArena>(Config::WorldArenaCapacity);
+
+	SetStage(EngineStage::Idle);
 	return 0;
 }
 
 void Engine::Run() {
-	m_Stage = EngineStage::Init;
+	if (m_Options.IsHashDiff()) {
+		m_ExitCode = StateHashRecorder::Diff(m_Options.hashDiffPaths[0],
+											 m_Options.hashDiffPaths[1]);
+		return;
+	}
+
+	if (m_Options.IsLevelConversion()) {
+		m_ExitCode = convertLevel(m_Options.convertLevelPaths[0],
+								  m_Options.convertLevelPaths[1])
+						 ? 0
+						 : 1;
+		return;
+	}
+
+	SetStage(EngineStage::Init);
+
+	if (m_Options.headless) {
+		// Nothing to present whilst waiting, so just initialise in place
+		if (!init()) return;
+
+		SetStage(EngineStage::Run);
+		HeadlessLoop();
+		return;
+	}
+
 	std::future<bool> initFuture = std::async(init);
 	while (true) {
 		processInput();
@@ -59,26 +168,67 @@ void Engine::Run() {
 
 	if (!initFuture.get()) return;
 
-	m_Stage = EngineStage::Run;
+	SetStage(EngineStage::Run);
 	GameLoop();
 }
 
 void Engine::Cleanup() {
-	m_Stage = EngineStage::Cleanup;
+	SetStage(EngineStage::Cleanup);
+
+	// Not set if setup failed
+	if (cleanup != nullptr) cleanup();
 
-	cleanup();
+	ReportFrameStats();
+	if (m_PerfCounters != nullptr) m_PerfCounters->Report(std::cout);
+
+#ifdef ENABLE_PROFILER
+	if (!m_Options.profileTracePath.empty()) {
+		Profiler::WriteChromeTrace(m_Options.profileTracePath);
+	}
+	if (!m_Options.profileCsvPath.empty()) {
+		Profiler::WriteFrameCsv(m_Options.profileCsvPath);
+	}
+#endif
+
+#ifdef ENABLE_ALLOC_TRACKING
+	AllocTracker::Report(std::cout);
+
+	uint64_t frame;
+	uint64_t maxFrameAllocs = AllocTracker::GetMaxFrameAllocations(&frame);
+	if (m_Options.maxFrameAllocs > 0 &&
+		maxFrameAllocs > m_Options.maxFrameAllocs) {
+		std::cerr << "FAIL: Frame " << frame << " made " << maxFrameAllocs
+				  << " allocations (limit " << m_Options.maxFrameAllocs << ")"
+				  << std::endl;
+		m_ExitCode = 1;
+	}
+#endif
 
 	CleanupSDL();
 
-	m_Stage = EngineStage::Idle;
+	SetStage(EngineStage::Idle);
 	m_IsCleanedUp = true;
 }
 
-void Engine::AddRenderOp(std::shared_ptr<RenderOp> renderOp) {
-	GetNextRenderBuffer().push_back(renderOp);
-}
-
 int Engine::SetupSDL() {
+	if (m_Options.renderBackend == RenderBackend::Software) {
+		return SetupSoftwareRenderer();
+	}
+
+	if (m_Options.headless) {
+		// Only events are needed (eg. to still handle SIGINT as quitting)
+		window = NULL;
+		renderer = NULL;
+
+		if (SDL_Init(SDL_INIT_EVENTS) < 0) {
+			std::cout << "Error: SDL2 initialization failed! " << SDL_GetError()
+					  << std::endl;
+			return 1;
+		}
+
+		return 0;
+	}
+
 	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) < 0) {
 		std::cout << "Error: SDL2 initialization failed! " << SDL_GetError()
 				  << std::endl;
@@ -94,8 +244,13 @@ int Engine::SetupSDL() {
 		return 1;
 	}
 
-	renderer = SDL_CreateRenderer(
-		window, -1, SDL_RENDERER_ACCELERATED | SDL_RENDERER_PRESENTVSYNC);
+	// Otherwise paced by the simulation thread instead
+	Uint32 rendererFlags = SDL_RENDERER_ACCELERATED;
+	if (m_Options.pacing == PacingMode::VSync) {
+		rendererFlags |= SDL_RENDERER_PRESENTVSYNC;
+	}
+
+	renderer = SDL_CreateRenderer(window, -1, rendererFlags);
 	if (renderer == NULL) {
 		std::cout << "Error: SDL2 Renderer creation failed! " << SDL_GetError()
 				  << std::endl;
@@ -107,72 +262,416 @@ int Engine::SetupSDL() {
 	return 0;
 }
 
+int Engine::SetupSoftwareRenderer() {
+	// The dummy driver needs no display, there's no window to present to
+	SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+
+	if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS) < 0) {
+		std::cout << "Error: SDL2 initialization failed! " << SDL_GetError()
+				  << std::endl;
+		return 1;
+	}
+
+	window = NULL;
+
+	m_SoftwareSurface = SDL_CreateRGBSurfaceWithFormat(
+		0, Config::ScreenWidth, Config::ScreenHeight, 32,
+		SDL_PIXELFORMAT_RGBA32);
+	if (m_SoftwareSurface == NULL) {
+		std::cout << "Error: SDL2 Surface creation failed! " << SDL_GetError()
+				  << std::endl;
+		return 1;
+	}
+
+	renderer = SDL_CreateSoftwareRenderer(m_SoftwareSurface);
+	if (renderer == NULL) {
+		std::cout << "Error: SDL2 Software renderer creation failed! "
+				  << SDL_GetError() << std::endl;
+		return 1;
+	}
+
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+	return 0;
+}
+
 void Engine::CleanupSDL() {
-	SDL_DestroyRenderer(Engine::Instance()->renderer);
-	SDL_DestroyWindow(Engine::Instance()->window);
+	if (m_StaticLayer != nullptr) m_StaticLayer->ReleaseTextures();
+
+	if (renderer != NULL) SDL_DestroyRenderer(renderer);
+	if (window != NULL) SDL_DestroyWindow(window);
+	if (m_SoftwareSurface != NULL) SDL_FreeSurface(m_SoftwareSurface);
+
+	if (m_Input != nullptr) {
+		SDL_DelEventWatch(&Input::EventWatch, m_Input.get());
+	}
 
 	SDL_Quit();
 }
 
 void Engine::GameLoop() {
+	PROFILE_THREAD("Main");
+
+	m_SimulationThread = std::thread(&Engine::SimulationLoop, this);
+
+	while (running) {
+		processInput();
+
+		if (WaitForRenderBufferPublished()) {
+			uint64_t submitStart = FrameStats::Now();
+			submitRender();
+			uint64_t presentTime = FrameStats::Now();
+			DumpFrame();
+
+			uint64_t inputTime = GetCurrentRenderBuffer().GetInputTime();
+			if (inputTime != 0) {
+				m_FrameStats->RecordInputLatency(inputTime, presentTime);
+			}
+
+			if (m_FramePacer != nullptr) {
+				m_FramePacer->RecordSubmitCost(presentTime - submitStart);
+			}
+		}
+	}
+
+	// Wake the simulation thread in case it's waiting on this thread
+	{ std::lock_guard<std::mutex> lock(m_RenderBufferMutex); }
+	m_RenderBufferCondVar.notify_all();
+	m_SimulationThread.join();
+}
+
+void Engine::SimulationLoop() {
+	PROFILE_THREAD("Simulation");
+	OpenPerfCounters();
+
+	m_SimulationThreadState = EngineThreadState::Running;
+
 	while (running) {
+		if (m_FramePacer != nullptr) {
+			// Input is latched at the start of the tick, so after waiting
+			m_FramePacer->WaitForNextFrame();
+
+			uint64_t start = FrameStats::Now();
+			UpdateTick();
+			m_FramePacer->RecordSimulationCost(FrameStats::Now() - start);
+		} else {
+			UpdateTick();
+		}
+
+		WaitForRenderBufferConsumed();
+	}
+
+	m_SimulationThreadState = EngineThreadState::Stopping;
+}
+
+void Engine::OpenPerfCounters() {
+	if (m_PerfCounters == nullptr) return;
+
+	// Carry on without them if unavailable
+	if (!m_PerfCounters->Open()) m_PerfCounters = nullptr;
+}
+
+void Engine::HeadlessLoop() {
+	PROFILE_THREAD("Main");
+	OpenPerfCounters();
+
+	auto start = std::chrono::steady_clock::now();
+
+	uint64_t ticks = 0;
+	while (running && (m_Options.ticks == 0 || ticks < m_Options.ticks)) {
+		processInput();
 		UpdateTick();
-		submitRender();
+
+		// Without a renderer the published ops are just dropped
+		if (m_RenderBuffers.Consume() && renderer != NULL) {
+			submitRender();
+			DumpFrame();
+		}
+
+		ticks += m_ScheduledFixedUpdateTicks;
+	}
+
+	double seconds = std::chrono::duration<double>(
+						 std::chrono::steady_clock::now() - start)
+						 .count();
+
+	std::cout << "Headless: ran " << ticks << " ticks in " << seconds
+			  << "s (" << (seconds > 0.0 ? ticks / seconds : 0.0)
+			  << " ticks/s)" << std::endl;
+}
+
+void Engine::DumpFrame() {
+	if (m_SoftwareSurface == NULL) return;
+
+	uint64_t frame = m_PresentedFrames++;
+	if (m_Options.dumpEvery == 0 || frame % m_Options.dumpEvery != 0) return;
+
+	if (SDL_MUSTLOCK(m_SoftwareSurface)) SDL_LockSurface(m_SoftwareSurface);
+
+	// FNV-1a over the visible pixels of each row (skipping the pitch padding)
+	uint64_t checksum = 14695981039346656037ull;
+	const uint8_t* pixels = (const uint8_t*)m_SoftwareSurface->pixels;
+	size_t rowBytes = m_SoftwareSurface->w * 4;
+	for (int y = 0; y < m_SoftwareSurface->h; ++y) {
+		const uint8_t* row = pixels + y * m_SoftwareSurface->pitch;
+		for (size_t i = 0; i < rowBytes; ++i) {
+			checksum = (checksum ^ row[i]) * 1099511628211ull;
+		}
+	}
+
+	if (SDL_MUSTLOCK(m_SoftwareSurface)) SDL_UnlockSurface(m_SoftwareSurface);
+
+	char checksumHex[17];
+	snprintf(checksumHex, sizeof(checksumHex), "%016llx",
+			 (unsigned long long)checksum);
+	std::cout << "Frame " << frame << " checksum: " << checksumHex
+			  << std::endl;
+
+	if (m_Options.dumpDir.empty()) return;
+
+	std::string path = m_Options.dumpDir + "/frame_" +
+					   Utils::PrePadString(std::to_string(frame), 6, '0') +
+					   ".bmp";
+	if (SDL_SaveBMP(m_SoftwareSurface, path.c_str()) < 0) {
+		std::cerr << "Couldn't save frame dump: '" << path << "'! "
+				  << SDL_GetError() << std::endl;
 	}
 }
 
 void Engine::ExecuteRenderOps() {
+	PROFILE_SCOPE("Engine::ExecuteRenderOps");
+	ALLOC_SCOPE("Engine::ExecuteRenderOps");
+
 	// Execute current buffer
-	std::sort(GetCurrentRenderBuffer().begin(), GetCurrentRenderBuffer().end(),
-			  [](std::shared_ptr<RenderOp>& l, std::shared_ptr<RenderOp>& r) {
-				  return l->GetOrder() < r->GetOrder();
-			  });
-	for (auto renderOp : GetCurrentRenderBuffer()) {
-		renderOp->Execute();
+	RenderBuffer& renderBuffer = GetCurrentRenderBuffer();
+
+	m_RenderBatchArena.Reset();
+
+	// Sorting by the packed keys also groups ops of the same type + color
+	// together within each order, so they end up adjacent for batching
+	renderBuffer.Sort(m_RenderBatchArena);
+
+	RenderBatch* batches;
+	size_t batchCount = RenderBatch::Build(
+		renderBuffer.GetOps(), renderBuffer.GetKeys(), renderBuffer.size(),
+		m_RenderBatchArena, &batches);
+	int drawCallCount = 0;
+	for (size_t i = 0; i < batchCount; ++i) {
+		drawCallCount += batches[i].Execute(renderer);
 	}
+
+	m_RenderOpCount = renderBuffer.size();
+	m_DrawCallCount = drawCallCount;
+}
+
+const char* GetEngineStageName(EngineStage stage) {
+	switch (stage) {
+		case EngineStage::Idle:
+			return "Idle";
+		case EngineStage::Setup:
+			return "Setup";
+		case EngineStage::Init:
+			return "Init";
+		case EngineStage::Run:
+			return "Run";
+		case EngineStage::ProcessInput:
+			return "ProcessInput";
+		case EngineStage::PreFixedUpdate:
+			return "PreFixedUpdate";
+		case EngineStage::FixedUpdate:
+			return "FixedUpdate";
+		case EngineStage::PostFixedUpdate:
+			return "PostFixedUpdate";
+		case EngineStage::Update:
+			return "Update";
+		case EngineStage::Render:
+			return "Render";
+		case EngineStage::Cleanup:
+			return "Cleanup";
+	}
+
+	return "Unknown";
+}
+
+void Engine::SetStage(EngineStage stage) {
+	uint64_t now = FrameStats::Now();
+	if (m_StageStartTime != 0) {
+		if (m_FrameStats != nullptr) {
+			m_FrameStats->RecordStage(m_Stage, now - m_StageStartTime);
+		}
+
+#ifdef ENABLE_PROFILER
+		Profiler::Record(GetEngineStageName(m_Stage), "Stage",
+						 m_StageStartTime, now);
+#endif
+	}
+
+#ifdef ENABLE_ALLOC_TRACKING
+	AllocTracker::SetStage((int)stage);
+#endif
+
+	if (m_PerfCounters != nullptr) m_PerfCounters->Sample((int)stage);
+
+	// Idle + Run are just between the other stages, so aren't timed
+	bool timed = stage != EngineStage::Idle && stage != EngineStage::Run;
+	m_StageStartTime = timed ? now : 0;
+
+	m_Stage = stage;
+}
+
+void Engine::ReportFrameStats() const {
+	if (m_FrameStats != nullptr) m_FrameStats->Report(std::cout);
+	if (m_FrameGovernor != nullptr) m_FrameGovernor->Report(std::cout);
 }
 
 void Engine::UpdateTimeStates() {
-	m_ScheduledFixedUpdateTicks =
-		m_TimeState->Update(SDL_GetPerformanceCounter());
+	uint64_t perfCounter;
+	if (m_InputPlayer != nullptr) {
+		InputRecordingFrame frame;
+		if (m_InputPlayer->ReadFrame(frame)) {
+			m_VirtualPerfCounter += frame.perfDelta;
+			m_Input->SetKeys(frame.keys,
+							 m_TimeState->GetTimeAt(m_VirtualPerfCounter));
+		} else {
+			// Finish off the current frame without advancing time
+			std::cout << "Replay finished" << std::endl;
+			running = false;
+		}
+
+		perfCounter = m_VirtualPerfCounter;
+	} else if (m_Options.headless) {
+		// Advance the virtual clock by exactly one fixed time step
+		m_VirtualPerfCounter += Config::FixedTimeStep * m_VirtualPerfFreq;
+		perfCounter = m_VirtualPerfCounter;
+		// Any events are on the real clock, so just take them all
+		m_Input->Latch(UINT64_MAX);
+	} else {
+		perfCounter = SDL_GetPerformanceCounter();
+		m_Input->Latch(perfCounter);
+	}
+
+	if (m_InputRecorder != nullptr) {
+		m_InputRecorder->WriteFrame(
+			{perfCounter - m_LastPerfCounter, m_Input->GetKeys()});
+	}
+
+	m_LastPerfCounter = perfCounter;
+	m_ScheduledFixedUpdateTicks = m_TimeState->Update(perfCounter);
 }
 
 void Engine::UpdateTick() {
-	m_Stage = EngineStage::Run;
+	PROFILE_FRAME();
+	uint64_t frameStart = FrameStats::Now();
+	m_FrameStats->BeginFrame(frameStart);
+	if (m_PerfCounters != nullptr) m_PerfCounters->BeginFrame();
+#ifdef ENABLE_ALLOC_TRACKING
+	AllocTracker::BeginFrame();
+#endif
+
+	SetStage(EngineStage::Run);
 	UpdateTimeStates();
 
-	m_Stage = EngineStage::ProcessInput;
-	processInput();
-
+	uint64_t fixedUpdateTime = 0;
 	if (m_ScheduledFixedUpdateTicks > 0) {
-		m_Stage = EngineStage::PreFixedUpdate;
+		SetStage(EngineStage::PreFixedUpdate);
 		preFixedUpdate();
+		m_TransformSystem->Snapshot();
 
-		m_Stage = EngineStage::FixedUpdate;
+		SetStage(EngineStage::FixedUpdate);
+		uint64_t fixedUpdateStart = FrameStats::Now();
 		for (int i = 0; i < m_ScheduledFixedUpdateTicks; ++i) {
 			fixedUpdate();
+
+			if (m_StateHashRecorder != nullptr) {
+				m_StateHashRecorder->RecordTick(m_FixedTickCount);
+			}
+			m_FixedTickCount++;
 		}
+		fixedUpdateTime = FrameStats::Now() - fixedUpdateStart;
 
+		SetStage(EngineStage::PostFixedUpdate);
 		postFixedUpdate();
 	}
 
-	m_Stage = EngineStage::Update;
+	SetStage(EngineStage::Update);
+	m_TransformSystem->Interpolate(GetInterpolation());
 	update();
 
-	m_Stage = EngineStage::Render;
+	SetStage(EngineStage::Render);
+	m_RenderableGrid->Update();
 	render();
+	RenderStaticLayer();
 
+	int renderOpCount = GetNextRenderBuffer().size();
+	GetNextRenderBuffer().SetInputTime(m_Input->TakeConsumedInputTime());
 	NextRenderBuffer();
+
+	SetStage(EngineStage::Run);
+
+	uint64_t frameEnd = FrameStats::Now();
+	m_FrameStats->EndFrame(frameEnd, m_ScheduledFixedUpdateTicks,
+						   renderOpCount);
+	if (m_FrameGovernor != nullptr) {
+		m_FrameGovernor->Update(frameStart, frameEnd, fixedUpdateTime,
+								m_ScheduledFixedUpdateTicks,
+								m_TimeState->GetDroppedTicks());
+	}
+	if (m_PerfCounters != nullptr) m_PerfCounters->EndFrame();
+#ifdef ENABLE_ALLOC_TRACKING
+	AllocTracker::EndFrame();
+#endif
+}
+
+void Engine::RenderStaticLayer() {
+	m_StaticLayer->Update();
+
+	if (m_StaticLayer->IsEmpty() || m_Camera == nullptr) return;
+
+	const AABB& camAABB = m_Camera->GetEntity()->visualAABB;
+	Vec2 min, max;
+	camAABB.GetMinMax(min, max);
+
+	AddRenderOp(RenderOp::StaticLayer(
+		(SDL_FRect){min.x, min.y, max.x - min.x, max.y - min.y}));
 }
 
 void Engine::NextRenderBuffer() {
-	// Update indexes
-	m_RenderingRenderBufferIndex = m_PreparingRenderBufferIndex;
-	m_PreparingRenderBufferIndex =
-		(m_PreparingRenderBufferIndex + 1) % m_RenderBufferSize;
+	m_RenderBuffers.Publish();
+
+	// Lock + unlock to ensure the main thread is either waiting or yet to check
+	// for a pending buffer, otherwise the notification could be missed
+	{ std::lock_guard<std::mutex> lock(m_RenderBufferMutex); }
+	m_RenderBufferCondVar.notify_all();
+
+	// Clear buffer for new data to be added, this only rewinds its arena
+	GetNextRenderBuffer().Clear();
+
+	// Frees the frame before last's transient data
+	m_FrameArenaIndex = 1 - m_FrameArenaIndex;
+	m_FrameArenas[m_FrameArenaIndex].Reset();
+}
+
+void Engine::WaitForRenderBufferConsumed() {
+	std::unique_lock<std::mutex> lock(m_RenderBufferMutex);
+	m_RenderBufferCondVar.wait(lock, [this]() {
+		return !m_RenderBuffers.HasPending() || !running;
+	});
+}
+
+bool Engine::WaitForRenderBufferPublished() {
+	{
+		std::unique_lock<std::mutex> lock(m_RenderBufferMutex);
+		m_RenderBufferCondVar.wait_for(
+			lock, std::chrono::milliseconds(1),
+			[this]() { return m_RenderBuffers.HasPending() || !running; });
+	}
+
+	if (!m_RenderBuffers.Consume()) return false;
+
+	{ std::lock_guard<std::mutex> lock(m_RenderBufferMutex); }
+	m_RenderBufferCondVar.notify_all();
 
-	// Clear buffer for new data to be added
-	GetNextRenderBuffer().clear();
+	return true;
 }
 
 int Engine::RegisterEntityCollection(
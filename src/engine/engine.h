@@ -2,24 +2,47 @@
 
 #include <SDL.h>
 
+#include <atomic>
+#include <condition_variable>
 #include <future>
 #include <memory>
 #include <thread>
 #include <vector>
 
 #include "engine/components/physics.h"
+#include "engine/engine_stage.h"
+#include "engine/frame_governor.h"
+#include "engine/frame_pacer.h"
+#include "engine/frame_stats.h"
 #include "engine/input.h"
+#include "engine/input_recording.h"
+#include "engine/options.h"
+#include "engine/perf_counters.h"
+#include "engine/profiler.h"
+#include "engine/renderable_grid.h"
 #include "engine/renderop.h"
+#include "engine/state_hash.h"
+#include "engine/static_layer.h"
 #include "engine/timestate.h"
+#include "engine/transform_system.h"
+#include "engine/types/frame_allocator.h"
 #include "engine/types/proxy_vector.h"
+#include "engine/types/triple_buffer.h"
+#include "engine/world_arena.h"
 
 // The engine is responsible for handling when each stage of the game loop is
 // meant to occur, handling internal systems (such as SDL) and providing an easy
 // to use API for the game to interface with
 
+// The simulation (fixed updates, updates and render op generation) runs on its
+// own thread, whilst the main thread only polls SDL events and executes the
+// published render ops. Completed render buffers are handed over through a
+// lock-free triple buffer, so frame N+1 is simulated whilst frame N is drawn.
+
 class Engine;
 class EntityCollection;
 class Camera;
+class TileMap;
 
 // List of function types that are used by the engine and declared externally by
 // the game
@@ -36,21 +59,10 @@ typedef void GameSubmitRender();
 
 typedef void GameIdling();
 
-enum class EngineStage {
-	Idle,
-	Setup,
-	Init,
-	Run,
-	ProcessInput,
-	PreFixedUpdate,
-	FixedUpdate,
-	PostFixedUpdate,
-	Update,
-	Render,
-	Cleanup,
-};
+typedef bool GameConvertLevel(const std::string &textPath,
+							  const std::string &levelPath);
 
-enum class EngineRenderThreadState {
+enum class EngineThreadState {
 	Paused,
 	Running,
 	Stopping,
@@ -75,18 +87,90 @@ class Engine {
 
 	void ExecuteRenderOps();
 
-	void AddRenderOp(std::shared_ptr<RenderOp> renderOp);
+	// Stats from the last executed render buffer
+	inline int GetRenderOpCount() const { return m_RenderOpCount; }
+	inline int GetDrawCallCount() const { return m_DrawCallCount; }
+
+	inline void AddRenderOp(const RenderOp &renderOp) {
+		GetNextRenderBuffer().Add(renderOp);
+	}
+
+	// Scratch memory for transient data on the simulation thread, which stays
+	// valid until the end of the next frame (so the last frame's data can still
+	// be read), after which it's reused
+	inline LinearArena &GetFrameArena() {
+		return m_FrameArenas[m_FrameArenaIndex];
+	}
+
+	template <typename T>
+	inline FrameAllocator<T> GetFrameAllocator() {
+		return FrameAllocator<T>(&GetFrameArena());
+	}
 
 	inline std::shared_ptr<TimeState> GetTimeState() const {
 		return m_TimeState;
 	}
+
+	inline const EngineOptions &GetOptions() const { return m_Options; }
+	// Exit code for the process once the engine has been cleaned up
+	inline int GetExitCode() const { return m_ExitCode; }
+
+	// Prints the frame time percentiles etc. so far, can be called from any
+	// thread
+	void ReportFrameStats() const;
+
+	// Null if the run must be deterministic (see 'frame_governor.h')
+	inline std::shared_ptr<FrameGovernor> GetFrameGovernor() const {
+		return m_FrameGovernor;
+	}
+
+	// Whether optional work at 'level' should be skipped due to overload
+	inline bool IsDegraded(DegradationLevel level) const {
+		return m_FrameGovernor != nullptr && m_FrameGovernor->IsDegraded(level);
+	}
+
+	// Null unless enabled + available (only valid on the simulation thread)
+	inline std::shared_ptr<PerfCounters> GetPerfCounters() const {
+		return m_PerfCounters;
+	}
+
+	// Number of fixed ticks simulated so far
+	inline uint64_t GetFixedTickCount() const { return m_FixedTickCount; }
+	inline bool IsHeadless() const { return m_Options.headless; }
+	inline bool HasRenderer() const { return renderer != nullptr; }
 	inline std::shared_ptr<Input> GetInput() const { return m_Input; }
 
 	inline std::shared_ptr<Camera> GetCamera() const { return m_Camera; }
 
+	inline std::shared_ptr<StaticLayer> GetStaticLayer() const {
+		return m_StaticLayer;
+	}
+
+	inline std::shared_ptr<RenderableGrid> GetRenderableGrid() const {
+		return m_RenderableGrid;
+	}
+
+	inline std::shared_ptr<TransformSystem> GetTransformSystem() const {
+		return m_TransformSystem;
+	}
+
+	// Where the current level's entities + components are allocated from
+	inline std::shared_ptr<WorldArena> GetWorldArena() const {
+		return m_WorldArena;
+	}
+
 	inline void SetCamera(std::shared_ptr<Camera> camera) { m_Camera = camera; }
 
+	inline std::shared_ptr<TileMap> GetTileMap() const { return m_TileMap; }
+
+	inline void SetTileMap(std::shared_ptr<TileMap> tileMap) {
+		m_TileMap = tileMap;
+	}
+
 	inline EngineStage GetStage() const { return m_Stage; }
+	inline EngineThreadState GetSimulationThreadState() const {
+		return m_SimulationThreadState;
+	}
 	inline bool CanAddOrRemoveEntities() const {
 		return m_Stage == EngineStage::Idle || m_Stage == EngineStage::Setup ||
 			   m_Stage == EngineStage::Init || m_Stage == EngineStage::Run ||
@@ -95,7 +179,10 @@ class Engine {
 	}
 
 	inline double GetInterpolation() const {
-		return doInterpolation ? m_TimeState->GetFixedStepProgress() : 1.0;
+		return doInterpolation &&
+					   !IsDegraded(DegradationLevel::NoInterpolation)
+				   ? m_TimeState->GetFixedStepProgress()
+				   : 1.0;
 	}
 
 	inline std::vector<std::shared_ptr<EntityCollection>>
@@ -125,56 +212,111 @@ class Engine {
 
    private:
 	int SetupSDL();
+	int SetupSoftwareRenderer();
 	void CleanupSDL();
 
+	// Dumps the software renderer's framebuffer if this frame is due
+	void DumpFrame();
+
 	void GameLoop();
+	void SimulationLoop();
+
+	// Opens the performance counters (if enabled) for the calling thread
+	void OpenPerfCounters();
+	// Runs the simulation on the calling thread off the virtual clock
+	void HeadlessLoop();
+
+	// Sets the current stage, which (if profiling) is timed until the next
+	// stage is set
+	void SetStage(EngineStage stage);
 
 	void UpdateTimeStates();
 
 	void UpdateTick();
 
+	void RenderStaticLayer();
+
 	void NextRenderBuffer();
 
-	inline std::vector<std::shared_ptr<RenderOp>> &GetCurrentRenderBuffer() {
-		return m_RenderBuffer[m_RenderingRenderBufferIndex];
+	// Blocks the simulation thread until the last published render buffer has
+	// been picked up, keeping it at most a single frame ahead of presentation
+	void WaitForRenderBufferConsumed();
+	// Blocks the main thread until a new render buffer is published (or a
+	// short timeout elapses, so events keep being polled)
+	bool WaitForRenderBufferPublished();
+
+	inline RenderBuffer &GetCurrentRenderBuffer() {
+		return m_RenderBuffers.GetReadBuffer();
 	}
 
-	inline std::vector<std::shared_ptr<RenderOp>> &GetNextRenderBuffer() {
-		return m_RenderBuffer[m_PreparingRenderBufferIndex];
+	inline RenderBuffer &GetNextRenderBuffer() {
+		return m_RenderBuffers.GetWriteBuffer();
 	}
 
 	int RegisterEntityCollection(std::shared_ptr<EntityCollection> collection);
 	void UnregisterEntityCollection(int id);
 
    public:
-	GameInit *init;
-	GameCleanup *cleanup;
+	GameInit *init = nullptr;
+	GameCleanup *cleanup = nullptr;
+
+	GameProcessInput *processInput = nullptr;
+	GamePreFixedUpdate *preFixedUpdate = nullptr;
+	GameFixedUpdate *fixedUpdate = nullptr;
+	GamePostFixedUpdate *postFixedUpdate = nullptr;
+	GameUpdate *update = nullptr;
+	GameRender *render = nullptr;
+	GameSubmitRender *submitRender = nullptr;
 
-	GameProcessInput *processInput;
-	GamePreFixedUpdate *preFixedUpdate;
-	GameFixedUpdate *fixedUpdate;
-	GamePostFixedUpdate *postFixedUpdate;
-	GameUpdate *update;
-	GameRender *render;
-	GameSubmitRender *submitRender;
+	GameIdling *idling = nullptr;
 
-	GameIdling *idling;
+	GameConvertLevel *convertLevel = nullptr;
 
-	SDL_Window *window;
-	SDL_Renderer *renderer;
+	SDL_Window *window = nullptr;
+	SDL_Renderer *renderer = nullptr;
 	SDL_Event event;
 
-	bool running = true;
-	bool doInterpolation = true;
+	// Shared between the main and simulation threads
+	std::atomic<bool> running = true;
+	std::atomic<bool> doInterpolation = true;
 
    private:
 	friend class EntityCollection;
 	int m_ScheduledFixedUpdateTicks = 0;
 
 	EngineStage m_Stage;
+	// When the current stage was set, 0 if it isn't being timed
+	uint64_t m_StageStartTime = 0;
+
+	std::shared_ptr<FrameStats> m_FrameStats;
+	std::shared_ptr<FrameGovernor> m_FrameGovernor;
+	// Null when presentation is paced by vsync (or headless)
+	std::shared_ptr<FramePacer> m_FramePacer;
+	std::shared_ptr<PerfCounters> m_PerfCounters;
 	bool m_IsSetupAndIdling;
 	bool m_IsCleanedUp;
 
+	EngineOptions m_Options;
+	int m_ExitCode = 0;
+
+	uint64_t m_FixedTickCount = 0;
+	std::shared_ptr<StateHashRecorder> m_StateHashRecorder;
+
+	// Frequency of the virtual clock which drives the time state when
+	// headless, advancing exactly one fixed time step per tick
+	static constexpr uint64_t m_VirtualPerfFreq = 1000000000;
+	uint64_t m_VirtualPerfCounter = 0;
+	// Counter the time state was last updated with
+	uint64_t m_LastPerfCounter = 0;
+
+	std::shared_ptr<InputRecorder> m_InputRecorder;
+	// Drives the input and the (virtual) clock when replaying
+	std::shared_ptr<InputPlayer> m_InputPlayer;
+
+	// Offscreen framebuffer drawn into by the software renderer
+	SDL_Surface *m_SoftwareSurface = nullptr;
+	uint64_t m_PresentedFrames = 0;
+
 	std::shared_ptr<TimeState> m_TimeState;
 	std::shared_ptr<Input> m_Input;
 
@@ -194,12 +336,36 @@ class Engine {
 	// Singleton camera
 	std::shared_ptr<Camera> m_Camera;
 
+	// Singleton tile map (if the game uses one)
+	std::shared_ptr<TileMap> m_TileMap;
+
+	std::shared_ptr<StaticLayer> m_StaticLayer;
+	std::shared_ptr<RenderableGrid> m_RenderableGrid;
+	std::shared_ptr<TransformSystem> m_TransformSystem;
+	std::shared_ptr<WorldArena> m_WorldArena;
+
 	// Rendering
-	// Double-buffered render operations for threading
-	static constexpr int m_RenderBufferSize = 2;
-	std::vector<std::shared_ptr<RenderOp>> m_RenderBuffer[m_RenderBufferSize];
-	int m_RenderingRenderBufferIndex;
-	int m_PreparingRenderBufferIndex;
+	// Triple-buffered render operations, written by the simulation thread and
+	// executed by the main thread
+	TripleBuffer<RenderBuffer> m_RenderBuffers;
+
+	// Double-buffered frame arenas, flipped along with the render buffers
+	LinearArena m_FrameArenas[2];
+	int m_FrameArenaIndex = 0;
+
+	// Scratch memory for batching the render buffer being executed
+	LinearArena m_RenderBatchArena;
+
+	std::atomic<int> m_RenderOpCount;
+	std::atomic<int> m_DrawCallCount;
+
+	std::thread m_SimulationThread;
+	std::atomic<EngineThreadState> m_SimulationThreadState;
+
+	// Only used to sleep whilst waiting on the other thread, the render buffers
+	// themselves are exchanged without locking
+	std::mutex m_RenderBufferMutex;
+	std::condition_variable m_RenderBufferCondVar;
 
 	std::thread m_IdlingThread;
 	std::condition_variable m_IdlingCondVar;
@@ -0,0 +1,22 @@
+#pragma once
+
+// The engine's stages, kept apart from 'engine.h' so the per stage stats (eg.
+// 'frame_stats.h') can size their arrays without depending on the engine
+
+enum class EngineStage {
+	Idle,
+	Setup,
+	Init,
+	Run,
+	ProcessInput,
+	PreFixedUpdate,
+	FixedUpdate,
+	PostFixedUpdate,
+	Update,
+	Render,
+	Cleanup,
+};
+
+constexpr int EngineStageCount = (int)EngineStage::Cleanup + 1;
+
+const char *GetEngineStageName(EngineStage stage);
@@ -2,32 +2,41 @@
 
 #include <iostream>
 
+#include "engine/alloc_tracker.h"
 #include "engine/component.h"
 #include "engine/components/physics.h"
 #include "engine/engine.h"
 #include "engine/mathutils.h"
+#include "engine/profiler.h"
+#include "engine/state_hash.h"
 #include "engine/types/entity_collection.h"
 #include "utils.h"
 
-#define EntityComponentsFunctionCall(FuncName)           \
-	for (const auto& componentPair : m_Components) {     \
-		if (!componentPair.second->IsActive()) continue; \
-		componentPair.second->FuncName();                \
+#define EntityComponentsFunctionCall(FuncName)                               \
+	for (const auto& componentPair : m_Components) {                         \
+		if (!componentPair.second->IsActive()) continue;                     \
+		PROFILE_SCOPE_CATEGORY(componentPair.first.GetName(), #FuncName);    \
+		ALLOC_SCOPE(componentPair.first.GetName());                          \
+		componentPair.second->FuncName();                                    \
 	}
 
 Entity::Entity(Vec2 pos, Vec2 halfSize)
 	: aabb({pos, halfSize}),
 	  visualAABB({pos, halfSize}),
-	  lastPos(pos),
+	  m_State(EntityState::QueuedForCreation),
 	  m_Active(true),
-	  m_State(EntityState::QueuedForCreation) {}
+	  m_Static(false),
+	  m_TransformIndex(-1),
+	  m_Collection(nullptr) {}
 
 Entity::Entity(AABB aabb)
 	: aabb(aabb),
 	  visualAABB(aabb),
-	  lastPos(aabb.pos),
+	  m_State(EntityState::QueuedForCreation),
 	  m_Active(true),
-	  m_State(EntityState::QueuedForCreation) {}
+	  m_Static(false),
+	  m_TransformIndex(-1),
+	  m_Collection(nullptr) {}
 
 void Entity::SetActive(bool value) {
 	if (m_Active == value) return;
@@ -42,6 +51,11 @@ void Entity::SetActive(bool value) {
 	}
 }
 
+void Entity::SetStatic(bool value) {
+	ASSERT(m_Components.empty() && m_TransformIndex == -1);
+	m_Static = value;
+}
+
 void Entity::Setup() {
 	for (const auto& componentPair : m_Components) {
 		const auto& component = componentPair.second;
@@ -71,12 +85,7 @@ void Entity::FixedUpdate() { EntityComponentsFunctionCall(FixedUpdate) }
 
 void Entity::PostFixedUpdate() { EntityComponentsFunctionCall(PostFixedUpdate) }
 
-void Entity::PreUpdate() {
-	visualAABB.pos =
-		Vec2::Lerp(lastPos, aabb.pos, Engine::Instance()->GetInterpolation());
-
-	EntityComponentsFunctionCall(PreUpdate)
-}
+void Entity::PreUpdate() { EntityComponentsFunctionCall(PreUpdate) }
 
 void Entity::Update() { EntityComponentsFunctionCall(Update) }
 
@@ -91,6 +100,18 @@ void Entity::OnHit(Hit* hit) {
 	}
 }
 
+void Entity::HashState(StateHash& hash) const {
+	hash.Add(m_Active);
+	hash.Add((int)m_State);
+	hash.Add(aabb.pos);
+
+	for (const auto& componentPair : m_Components) {
+		hash.Add((int)componentPair.first);
+		hash.Add(componentPair.second->IsActive());
+		componentPair.second->HashState(hash);
+	}
+}
+
 bool Entity::HasBody() {
 	return m_Components.count(EngineComponentType::StaticBody) ||
 		   m_Components.count(EngineComponentType::RigidBody);
@@ -110,7 +131,7 @@ std::shared_ptr<Component> Entity::AddComponent(
 	ASSERT(m_Components.count(component->m_Type) == 0);
 
 	auto type = component->m_Type;
-	component->m_Entity = shared_from_this();
+	component->m_Entity = this;
 	m_Components.emplace(type, component);
 
 	if (IsActive()) {
@@ -18,6 +18,7 @@ class Engine;
 class EntityCollection;
 
 class Body;
+class StateHash;
 
 enum class EntityState {
 	Normal,
@@ -33,6 +34,11 @@ class Entity : public std::enable_shared_from_this<Entity> {
 	inline bool IsActive() const { return m_Active; }
 	void SetActive(bool value);
 
+	// Static entities never move or change appearance (eg. level geometry),
+	// must be set before any components are added
+	inline bool IsStatic() const { return m_Static; }
+	void SetStatic(bool value);
+
 	void Setup();
 	void Cleanup();
 
@@ -51,6 +57,8 @@ class Entity : public std::enable_shared_from_this<Entity> {
 
 	void OnHit(Hit* hit);
 
+	void HashState(StateHash& hash) const;
+
 	bool HasBody();
 	std::shared_ptr<Body> GetBody();
 
@@ -82,20 +90,26 @@ class Entity : public std::enable_shared_from_this<Entity> {
 
    public:
 	AABB aabb;
+	// Interpolated by the engine's transform system for non-static entities
 	AABB visualAABB;
-	Vec2 lastPos;
 
 	std::string name;
 
    private:
 	friend class EntityCollection;
 	friend class Physics;
+	friend class TransformSystem;
 
 	EntityState m_State;
 	bool m_Active;
+	bool m_Static;
+
+	// Index within the transform system, -1 if not in it
+	int m_TransformIndex;
 
 	std::map<ComponentType, std::shared_ptr<Component>> m_Components;
-	std::shared_ptr<EntityCollection> m_Collection;
+	// Not owning, as the collection owns its entities
+	EntityCollection* m_Collection;
 
 	std::vector<std::shared_ptr<Component>> m_SetupQueue;
 };
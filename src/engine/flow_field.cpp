@@ -0,0 +1,156 @@
+#include "engine/flow_field.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "engine/components/tilemap.h"
+#include "utils.h"
+
+// Orthogonal steps first, the search only takes these
+static constexpr int StepCount = 8;
+static constexpr int OrthogonalStepCount = 4;
+static constexpr int StepOffsets[StepCount][2] = {
+	{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, 1}, {1, -1}, {-1, -1},
+};
+
+FlowField::FlowField(int radius, uint8_t collisionMask)
+	: m_Radius(radius),
+	  m_Size(radius * 2 + 1),
+	  m_CollisionMask(collisionMask),
+	  m_TileMap(nullptr),
+	  m_TileMapRevision(0),
+	  m_TileSize(0),
+	  m_TargetX(0),
+	  m_TargetY(0),
+	  m_WindowX(0),
+	  m_WindowY(0) {
+	ASSERT(radius > 0);
+
+	size_t cellCount = m_Size * m_Size;
+	m_Blocked.resize(cellCount);
+	m_Distances.resize(cellCount, m_Unreachable);
+	m_Steps.resize(cellCount, m_NoStep);
+	m_Queue.reserve(cellCount);
+}
+
+void FlowField::Update(const TileMap* tileMap, Vec2 target) {
+	if (tileMap == nullptr) {
+		m_TileMap = nullptr;
+		return;
+	}
+
+	Vec2 origin = tileMap->GetOrigin();
+	float tileSize = tileMap->GetTileSize();
+	int targetX = (int)floorf((target.x - origin.x) / tileSize);
+	int targetY = (int)floorf((target.y - origin.y) / tileSize);
+
+	if (tileMap == m_TileMap &&
+		tileMap->GetTileRevision() == m_TileMapRevision &&
+		targetX == m_TargetX && targetY == m_TargetY) {
+		return;
+	}
+
+	m_TileMap = tileMap;
+	m_TileMapRevision = tileMap->GetTileRevision();
+	m_Origin = origin;
+	m_TileSize = tileSize;
+	m_TargetX = targetX;
+	m_TargetY = targetY;
+	m_WindowX = targetX - m_Radius;
+	m_WindowY = targetY - m_Radius;
+
+	// Cells off the map are blocked too
+	for (int y = 0; y < m_Size; ++y) {
+		for (int x = 0; x < m_Size; ++x) {
+			int cellX = m_WindowX + x;
+			int cellY = m_WindowY + y;
+
+			m_Blocked[y * m_Size + x] =
+				cellX < 0 || cellY < 0 || cellX >= tileMap->GetWidth() ||
+				cellY >= tileMap->GetHeight() ||
+				(tileMap->GetCollisionLayer(cellX, cellY) & m_CollisionMask);
+		}
+	}
+
+	Search();
+}
+
+void FlowField::Search() {
+	std::fill(m_Distances.begin(), m_Distances.end(), m_Unreachable);
+	std::fill(m_Steps.begin(), m_Steps.end(), m_NoStep);
+
+	// The target is always at the center of the window, even if it's somehow
+	// within a blocked cell
+	int targetIndex = m_Radius * m_Size + m_Radius;
+	m_Distances[targetIndex] = 0;
+
+	m_Queue.clear();
+	m_Queue.push_back(targetIndex);
+	for (size_t i = 0; i < m_Queue.size(); ++i) {
+		int index = m_Queue[i];
+		int x = index % m_Size;
+		int y = index / m_Size;
+
+		for (int step = 0; step < OrthogonalStepCount; ++step) {
+			int nextX = x + StepOffsets[step][0];
+			int nextY = y + StepOffsets[step][1];
+			if (!IsInWindow(nextX, nextY)) continue;
+
+			int nextIndex = nextY * m_Size + nextX;
+			if (m_Blocked[nextIndex] ||
+				m_Distances[nextIndex] != m_Unreachable) {
+				continue;
+			}
+
+			m_Distances[nextIndex] = m_Distances[index] + 1;
+			m_Queue.push_back(nextIndex);
+		}
+	}
+
+	// Point every reached cell at its closest neighbour, which can be a
+	// diagonal as long as both of the cells beside it are open
+	for (int index : m_Queue) {
+		if (index == targetIndex) continue;
+
+		int x = index % m_Size;
+		int y = index / m_Size;
+
+		uint16_t bestDistance = m_Distances[index];
+		for (int step = 0; step < StepCount; ++step) {
+			int nextX = x + StepOffsets[step][0];
+			int nextY = y + StepOffsets[step][1];
+			if (!IsInWindow(nextX, nextY)) continue;
+
+			int nextIndex = nextY * m_Size + nextX;
+			if (m_Distances[nextIndex] >= bestDistance) continue;
+
+			if (step >= OrthogonalStepCount &&
+				(m_Blocked[y * m_Size + nextX] ||
+				 m_Blocked[nextY * m_Size + x])) {
+				continue;
+			}
+
+			bestDistance = m_Distances[nextIndex];
+			m_Steps[index] = step;
+		}
+	}
+}
+
+bool FlowField::GetDirection(Vec2 pos, Vec2& direction) const {
+	if (m_TileMap == nullptr) return false;
+
+	int x = (int)floorf((pos.x - m_Origin.x) / m_TileSize) - m_WindowX;
+	int y = (int)floorf((pos.y - m_Origin.y) / m_TileSize) - m_WindowY;
+	if (!IsInWindow(x, y)) return false;
+
+	uint8_t step = m_Steps[y * m_Size + x];
+	if (step == m_NoStep) return false;
+
+	// Head for the center of the next cell, rather than just in the step's
+	// direction, so agents are pulled away from the corners they go around
+	Vec2 nextCell(m_WindowX + x + StepOffsets[step][0],
+				  m_WindowY + y + StepOffsets[step][1]);
+	Vec2 next = m_Origin + (nextCell + 0.5f) * m_TileSize;
+	direction = (next - pos).Normalized();
+	return true;
+}
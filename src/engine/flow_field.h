@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "engine/types/vec2.h"
+
+class TileMap;
+
+// Shared path finding towards a single target (eg. for every enemy chasing the
+// player), rather than a search per agent. A breadth first search spreads out
+// from the target's cell across the tile map's walkable cells, then each cell
+// stores which neighbour heads closest to the target, so steering is an O(1)
+// lookup. It's only searched again once the target moves to a different cell.
+//
+// The field only covers the cells within a radius of the target, keeping its
+// cost independent of the map's size, beyond that agents should head straight
+// for the target. Diagonal steps never cut past the corner of a blocked cell.
+
+class FlowField {
+   public:
+	// Cells colliding with 'collisionMask' block the path
+	FlowField(int radius, uint8_t collisionMask);
+
+	// Searches again if the target moved cell (or the tile map changed)
+	void Update(const TileMap* tileMap, Vec2 target);
+
+	// Gets the direction to head in from 'pos' to follow the field, returns
+	// false if 'pos' is outside of it, can't reach the target or is already in
+	// the target's cell
+	bool GetDirection(Vec2 pos, Vec2& direction) const;
+
+   private:
+	void Search();
+
+	inline bool IsInWindow(int x, int y) const {
+		return x >= 0 && y >= 0 && x < m_Size && y < m_Size;
+	}
+
+   private:
+	static constexpr uint16_t m_Unreachable = UINT16_MAX;
+	static constexpr uint8_t m_NoStep = UINT8_MAX;
+
+	int m_Radius;
+	int m_Size;
+	uint8_t m_CollisionMask;
+
+	// Only compared against, to know when the map changes
+	const TileMap* m_TileMap;
+	uint32_t m_TileMapRevision;
+
+	Vec2 m_Origin;
+	float m_TileSize;
+
+	// Cell of the target, and of the window's first cell
+	int m_TargetX;
+	int m_TargetY;
+	int m_WindowX;
+	int m_WindowY;
+
+	// Per cell within the window
+	std::vector<bool> m_Blocked;
+	std::vector<uint16_t> m_Distances;
+	// Index of the neighbour to step to (see 'StepOffsets' in the source)
+	std::vector<uint8_t> m_Steps;
+
+	std::vector<int> m_Queue;
+};
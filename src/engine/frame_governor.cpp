@@ -0,0 +1,73 @@
+#include "engine/frame_governor.h"
+
+#include <iomanip>
+#include <iostream>
+
+#include "config.h"
+
+static const char* GetDegradationLevelName(DegradationLevel level) {
+	switch (level) {
+		case DegradationLevel::None:
+			return "None";
+		case DegradationLevel::NoInterpolation:
+			return "NoInterpolation";
+		case DegradationLevel::NoOutlines:
+			return "NoOutlines";
+		case DegradationLevel::ReducedOffscreenAI:
+			return "ReducedOffscreenAI";
+	}
+
+	return "Unknown";
+}
+
+FrameGovernor::FrameGovernor(double frameBudgetMs)
+	: m_FrameBudget(frameBudgetMs * 1e6) {}
+
+void FrameGovernor::Update(uint64_t frameStart, uint64_t frameEnd,
+						   uint64_t fixedUpdateTime, int fixedTicks,
+						   int droppedTicks) {
+	constexpr double smoothing = Config::GovernorSmoothing;
+
+	double load = (frameEnd - frameStart) / (double)m_FrameBudget;
+	m_Load = m_Load + (load - m_Load) * smoothing;
+	if (fixedTicks > 0) {
+		double cost = fixedUpdateTime / (double)fixedTicks;
+		m_FixedTickCost =
+			m_FixedTickCost + (cost - m_FixedTickCost) * smoothing;
+	}
+	m_DroppedTicks += droppedTicks;
+
+	// Dropping ticks means it's already too late, so step up straight away
+	bool overloaded = droppedTicks > 0 || m_Load > Config::GovernorHighLoad;
+	bool underloaded = m_Load < Config::GovernorLowLoad;
+
+	m_OverloadedFrames = overloaded ? m_OverloadedFrames + 1 : 0;
+	m_UnderloadedFrames = underloaded ? m_UnderloadedFrames + 1 : 0;
+
+	int level = m_Level;
+	if ((droppedTicks > 0 ||
+		 m_OverloadedFrames >= Config::GovernorEngageFrames) &&
+		level < (int)DegradationLevel::ReducedOffscreenAI) {
+		SetLevel(level + 1);
+	} else if (m_UnderloadedFrames >= Config::GovernorReleaseFrames &&
+			   level > (int)DegradationLevel::None) {
+		SetLevel(level - 1);
+	}
+}
+
+void FrameGovernor::Report(std::ostream& stream) const {
+	stream << "[Governor]: " << GetDegradationLevelName(GetLevel())
+		   << std::fixed << std::setprecision(2) << "  load "
+		   << m_Load.load() * 100.0 << "%  fixed tick "
+		   << m_FixedTickCost.load() / 1e6 << "ms  dropped ticks "
+		   << m_DroppedTicks.load() << std::defaultfloat << std::endl;
+}
+
+void FrameGovernor::SetLevel(int level) {
+	m_Level = level;
+	m_OverloadedFrames = 0;
+	m_UnderloadedFrames = 0;
+
+	std::cout << "[Governor]: Degradation level now "
+			  << GetDegradationLevelName((DegradationLevel)level) << std::endl;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+// Watches how much of the frame budget the simulation thread spends working
+// (and how long each fixed tick costs), degrading optional work under
+// sustained overload so the fixed tick cap (see 'timestate.h') doesn't have to
+// drop simulation time. Each level also includes the ones before it, and is
+// only stepped back down once the load has stayed low for a while.
+//
+// Off-screen AI changes the simulation, so the engine only uses a governor
+// when the run doesn't need to be deterministic (eg. not recording/replaying).
+
+enum class DegradationLevel {
+	None,
+	// Visuals snap to the latest fixed tick
+	NoInterpolation,
+	// Renderables only draw their fill
+	NoOutlines,
+	// Off-screen enemies re-steer every 'Config::OffscreenAITickInterval'
+	// fixed ticks
+	ReducedOffscreenAI,
+};
+
+class FrameGovernor {
+   public:
+	FrameGovernor(double frameBudgetMs);
+
+	// Simulation thread, with the times in nanoseconds
+	void Update(uint64_t frameStart, uint64_t frameEnd,
+				uint64_t fixedUpdateTime, int fixedTicks, int droppedTicks);
+
+	// Any thread
+	inline DegradationLevel GetLevel() const {
+		return (DegradationLevel)m_Level.load(std::memory_order_relaxed);
+	}
+	inline bool IsEngaged() const {
+		return GetLevel() != DegradationLevel::None;
+	}
+	inline bool IsDegraded(DegradationLevel level) const {
+		return GetLevel() >= level;
+	}
+
+	void Report(std::ostream& stream) const;
+
+   private:
+	void SetLevel(int level);
+
+   private:
+	uint64_t m_FrameBudget;
+
+	std::atomic<int> m_Level = 0;
+
+	// Smoothed fraction of the frame budget spent working
+	std::atomic<double> m_Load = 0.0;
+	// Smoothed cost of a single fixed tick (nanoseconds)
+	std::atomic<double> m_FixedTickCost = 0.0;
+	std::atomic<uint64_t> m_DroppedTicks = 0;
+
+	int m_OverloadedFrames = 0;
+	int m_UnderloadedFrames = 0;
+};
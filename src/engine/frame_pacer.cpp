@@ -0,0 +1,74 @@
+#include "engine/frame_pacer.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "config.h"
+#include "engine/frame_stats.h"
+
+FramePacer::FramePacer(PacingMode mode, double targetFps)
+	: m_Mode(mode),
+	  m_FramePeriod(1e9 / targetFps),
+	  m_NextDeadline(0),
+	  m_SimulationCosts(),
+	  m_CostIndex(0),
+	  m_SubmitCost(0) {}
+
+void FramePacer::WaitForNextFrame() {
+	uint64_t now = FrameStats::Now();
+
+	if (m_NextDeadline == 0 || now > m_NextDeadline + m_FramePeriod) {
+		// Just started or fell behind by over a frame, so resync rather than
+		// rushing through the missed frames
+		m_NextDeadline = now + m_FramePeriod;
+	}
+
+	uint64_t wakeTime = m_NextDeadline;
+	if (m_Mode == PacingMode::JustInTime) {
+		// Aim to have the frame presented right on the deadline
+		uint64_t cost = GetPredictedCost();
+		wakeTime = cost < m_FramePeriod ? m_NextDeadline - cost
+										: m_NextDeadline - m_FramePeriod;
+	}
+
+	SleepUntil(wakeTime);
+	m_NextDeadline += m_FramePeriod;
+}
+
+void FramePacer::RecordSimulationCost(uint64_t cost) {
+	m_SimulationCosts[m_CostIndex] = cost;
+	m_CostIndex = (m_CostIndex + 1) % Config::PacingCostWindow;
+}
+
+void FramePacer::RecordSubmitCost(uint64_t cost) {
+	m_SubmitCost.store(cost, std::memory_order_relaxed);
+}
+
+void FramePacer::SleepUntil(uint64_t deadline) {
+	constexpr uint64_t spinTime = Config::PacingSpinTime * 1e6;
+
+	uint64_t now = FrameStats::Now();
+	if (now + spinTime < deadline) {
+		std::this_thread::sleep_for(
+			std::chrono::nanoseconds(deadline - spinTime - now));
+	}
+
+	while (FrameStats::Now() < deadline) {
+#if defined(__SSE2__)
+		_mm_pause();
+#endif
+	}
+}
+
+uint64_t FramePacer::GetPredictedCost() const {
+	uint64_t simulationCost = *std::max_element(m_SimulationCosts.begin(),
+												 m_SimulationCosts.end());
+
+	return simulationCost + m_SubmitCost.load(std::memory_order_relaxed) +
+		   (uint64_t)(Config::PacingMargin * 1e6);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+#include "config.h"
+
+// Paces the simulation thread to a target frame rate when the renderer isn't
+// blocking on vsync, so input is latched (at the start of each frame) as late
+// as possible rather than up to a whole refresh before it's presented.
+//
+// Target waits until each frame's deadline before simulating it, whilst
+// just-in-time instead starts each frame so it's predicted to be presented
+// right on its deadline, from the worst simulation + submission cost over the
+// last 'Config::PacingCostWindow' frames.
+//
+// Waits sleep until the last 'Config::PacingSpinTime' before spinning, as
+// sleeps can overshoot by a lot more than that.
+
+enum class PacingMode {
+	VSync,
+	Target,
+	JustInTime,
+};
+
+class FramePacer {
+   public:
+	FramePacer(PacingMode mode, double targetFps);
+
+	// Simulation thread, blocks until the next frame should be simulated
+	void WaitForNextFrame();
+	void RecordSimulationCost(uint64_t cost);
+
+	// Main thread
+	void RecordSubmitCost(uint64_t cost);
+
+	// Blocks until 'FrameStats::Now()' reaches 'deadline'
+	static void SleepUntil(uint64_t deadline);
+
+   private:
+	uint64_t GetPredictedCost() const;
+
+   private:
+	PacingMode m_Mode;
+	// Nanoseconds
+	uint64_t m_FramePeriod;
+	uint64_t m_NextDeadline;
+
+	std::array<uint64_t, Config::PacingCostWindow> m_SimulationCosts;
+	int m_CostIndex;
+
+	// Only the latest, as it's written by the main thread
+	std::atomic<uint64_t> m_SubmitCost;
+};
@@ -0,0 +1,150 @@
+#include "engine/frame_stats.h"
+
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+
+#include "config.h"
+#include "engine/engine.h"
+
+FrameStats::FrameStats(double frameBudgetMs, const std::string& hitchPath)
+	: m_FrameBudget(frameBudgetMs * 1000000.0),
+	  m_HitchPath(hitchPath),
+	  m_History(std::make_unique<FrameTiming[]>(Config::HitchHistoryFrames)),
+	  m_Frame(0),
+	  m_FrameStart(0),
+	  m_InFrame(false),
+	  m_LastHitchDumpFrame(0),
+	  m_HasDumpedHitch(false) {}
+
+uint64_t FrameStats::Now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+void FrameStats::BeginFrame(uint64_t now) {
+	// The frame time is only known once the next frame begins, as it includes
+	// waiting on the main thread
+	if (m_FrameStart != 0) {
+		uint64_t frameTime = now - m_FrameStart;
+		GetTiming(m_Frame).frameTime = frameTime;
+		m_FrameTimes.Record(frameTime);
+
+		if (m_FrameBudget > 0 && frameTime > m_FrameBudget) DumpHitch();
+
+		m_Frame++;
+	}
+
+	FrameTiming& timing = GetTiming(m_Frame);
+	timing = {};
+	timing.frame = m_Frame;
+
+	m_FrameStart = now;
+	m_InFrame = true;
+}
+
+void FrameStats::RecordStage(EngineStage stage, uint64_t duration) {
+	if (!m_InFrame) return;
+	GetTiming(m_Frame).stageTimes[(int)stage] += duration;
+}
+
+void FrameStats::EndFrame(uint64_t now, int fixedTicks, int renderOps) {
+	FrameTiming& timing = GetTiming(m_Frame);
+	timing.simTime = now - m_FrameStart;
+	timing.fixedTicks = fixedTicks;
+	timing.renderOps = renderOps;
+
+	m_SimTimes.Record(timing.simTime);
+	m_FixedTicks.Record(fixedTicks);
+	m_RenderOps.Record(renderOps);
+
+	m_InFrame = false;
+}
+
+void FrameStats::RecordInputLatency(uint64_t inputTime, uint64_t now) {
+	m_InputLatencies.Record(now - inputTime);
+}
+
+void FrameStats::Report(std::ostream& stream) const {
+	std::ios::fmtflags flags = stream.flags();
+	std::streamsize precision = stream.precision();
+
+	auto reportRow = [&stream](const char* name, const Histogram& histogram,
+							   double scale, int decimals) {
+		stream << std::setprecision(decimals) << "  " << std::left
+			   << std::setw(20) << name << std::right;
+		stream << "p50 " << std::setw(10) << histogram.GetPercentile(50) * scale
+			   << "  p95 " << std::setw(10)
+			   << histogram.GetPercentile(95) * scale << "  p99 "
+			   << std::setw(10) << histogram.GetPercentile(99) * scale
+			   << "  max " << std::setw(10) << histogram.GetMax() * scale
+			   << std::endl;
+	};
+
+	stream << std::fixed;
+
+	stream << "[Frame Stats]: " << m_FrameTimes.GetCount() << " frames"
+		   << std::endl;
+	reportRow("Frame time (ms)", m_FrameTimes, 1.0 / 1000000.0, 3);
+	reportRow("Sim time (ms)", m_SimTimes, 1.0 / 1000000.0, 3);
+	reportRow("Fixed ticks", m_FixedTicks, 1.0, 0);
+	reportRow("Render ops", m_RenderOps, 1.0, 0);
+
+	if (m_InputLatencies.GetCount() > 0) {
+		reportRow("Input latency (ms)", m_InputLatencies, 1.0 / 1000000.0, 3);
+	}
+
+	stream.flags(flags);
+	stream.precision(precision);
+}
+
+FrameStats::FrameTiming& FrameStats::GetTiming(uint64_t frame) {
+	return m_History[frame % Config::HitchHistoryFrames];
+}
+
+void FrameStats::DumpHitch() {
+	if (!m_HitchFile.is_open()) {
+		m_HitchFile.open(m_HitchPath, std::ios::trunc);
+		if (!m_HitchFile.is_open()) {
+			std::cerr << "Couldn't open hitch file: '" << m_HitchPath << "'!"
+					  << std::endl;
+			// Don't keep retrying every hitch
+			m_FrameBudget = 0;
+			return;
+		}
+
+		m_HitchFile << "hitch_frame,frame,frame_ms,sim_ms,fixed_ticks,"
+					   "render_ops";
+		for (int stage = 0; stage < EngineStageCount; ++stage) {
+			m_HitchFile << "," << GetEngineStageName((EngineStage)stage)
+						<< "_ms";
+		}
+		m_HitchFile << "\n";
+	}
+
+	// Only the frames which haven't been dumped already (or overwritten)
+	uint64_t first = m_Frame + 1 >= Config::HitchHistoryFrames
+						 ? m_Frame + 1 - Config::HitchHistoryFrames
+						 : 0;
+	if (m_HasDumpedHitch && m_LastHitchDumpFrame + 1 > first) {
+		first = m_LastHitchDumpFrame + 1;
+	}
+
+	for (uint64_t frame = first; frame <= m_Frame; ++frame) {
+		const FrameTiming& timing = GetTiming(frame);
+
+		m_HitchFile << m_Frame << "," << timing.frame << ","
+					<< timing.frameTime / 1000000.0 << ","
+					<< timing.simTime / 1000000.0 << "," << timing.fixedTicks
+					<< "," << timing.renderOps;
+		for (int stage = 0; stage < EngineStageCount; ++stage) {
+			m_HitchFile << "," << timing.stageTimes[stage] / 1000000.0;
+		}
+		m_HitchFile << "\n";
+	}
+
+	m_HitchFile.flush();
+	m_LastHitchDumpFrame = m_Frame;
+	m_HasDumpedHitch = true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "engine/engine_stage.h"
+#include "engine/types/histogram.h"
+
+// Tracks the distribution of frame times, simulation times, fixed ticks per
+// frame, render ops per frame and input to present latencies, so hitches show
+// up in the percentiles rather than being hidden by an average. The simulation
+// thread records each frame whilst any thread can report the stats.
+//
+// If given a budget, any frame taking longer dumps the detailed stage timings
+// of the last 'Config::HitchHistoryFrames' frames to the hitch file.
+
+enum class EngineStage;
+
+class FrameStats {
+   public:
+	// A budget of 0 disables hitch capture
+	FrameStats(double frameBudgetMs, const std::string& hitchPath);
+
+	// Nanoseconds since an arbitrary point
+	static uint64_t Now();
+
+	// Simulation thread
+	void BeginFrame(uint64_t now);
+	void RecordStage(EngineStage stage, uint64_t duration);
+	void EndFrame(uint64_t now, int fixedTicks, int renderOps);
+
+	// Main thread, once a frame acting on input (polled at 'inputTime') has
+	// been presented
+	void RecordInputLatency(uint64_t inputTime, uint64_t now);
+
+	// Any thread
+	void Report(std::ostream& stream) const;
+
+   private:
+	struct FrameTiming {
+		uint64_t frame;
+		uint64_t frameTime;
+		uint64_t simTime;
+		int fixedTicks;
+		int renderOps;
+		uint64_t stageTimes[EngineStageCount];
+	};
+
+	FrameTiming& GetTiming(uint64_t frame);
+
+	void DumpHitch();
+
+   private:
+	Histogram m_FrameTimes;
+	Histogram m_SimTimes;
+	Histogram m_FixedTicks;
+	Histogram m_RenderOps;
+	Histogram m_InputLatencies;
+
+	uint64_t m_FrameBudget;
+	std::string m_HitchPath;
+	std::ofstream m_HitchFile;
+
+	// Ring buffer of the most recent frames' timings
+	std::unique_ptr<FrameTiming[]> m_History;
+
+	uint64_t m_Frame;
+	uint64_t m_FrameStart;
+	bool m_InFrame;
+
+	// Avoids dumping overlapping frames for consecutive hitches
+	uint64_t m_LastHitchDumpFrame;
+	bool m_HasDumpedHitch;
+};
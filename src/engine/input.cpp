@@ -3,33 +3,45 @@
 #include <iostream>
 
 #include "engine/engine.h"
+#include "engine/frame_stats.h"
 #include "utils.h"
 
-ActionData::ActionData() : m_StartTime(-1), m_EndTime(-1), m_Value(false) {}
+ActionData::ActionData()
+	: m_Value(false),
+	  m_StartTime(-1),
+	  m_EndTime(-1),
+	  m_StartFrame(0),
+	  m_EndFrame(0) {}
 
-void ActionData::Start(bool value) {
-	if (IsNew() == IsExpired()) return;
+void ActionData::Start(double time, uint64_t frame) {
+	if (IsHeld()) return;
 
-	m_StartTime = Engine::Instance()->GetTimeState()->GetTime();
+	m_StartTime = time;
+	m_StartFrame = frame;
 	m_EndTime = -1;
 
-	m_Value = value;
+	m_Value = true;
 }
 
-void ActionData::Stop(bool value) {
-	if (IsNew() || IsExpired()) return;
+void ActionData::Stop(double time, uint64_t frame) {
+	if (!IsHeld()) return;
 
-	m_EndTime = Engine::Instance()->GetTimeState()->GetTime();
+	m_EndTime = time;
+	m_EndFrame = frame;
 
-	m_Value = value;
+	m_Value = false;
 }
 
-float ActionData::GetStartTime() const { return m_StartTime; }
-float ActionData::GetEndTime() const { return m_EndTime; };
+double ActionData::GetStartTime() const { return m_StartTime; }
+double ActionData::GetEndTime() const { return m_EndTime; }
 
-float ActionData::GetDuration() const {
-	return Engine::Instance()->GetTimeState()->GetTime() - m_StartTime;
-};
+double ActionData::GetDuration() const {
+	if (IsHeld()) {
+		return Engine::Instance()->GetTimeState()->GetTime() - m_StartTime;
+	}
+
+	return m_EndTime - m_StartTime;
+}
 
 bool ActionData::IsHeld() const { return m_StartTime != -1 && m_EndTime == -1; }
 
@@ -38,40 +50,120 @@ bool ActionData::InPhase() const {
 }
 
 bool ActionData::IsStarted() const {
-	return Engine::Instance()->GetTimeState()->GetTime() == m_StartTime;
-}
-bool ActionData::IsPerformed() const {
-	return Engine::Instance()->GetTimeState()->GetTime() != m_EndTime;
+	return !IsNew() &&
+		   m_StartFrame == Engine::Instance()->GetInput()->GetFrame();
 }
+bool ActionData::IsPerformed() const { return IsHeld() && !IsStarted(); }
 bool ActionData::IsStopped() const {
-	return Engine::Instance()->GetTimeState()->GetTime() == m_EndTime;
+	return m_EndTime != -1 &&
+		   m_EndFrame == Engine::Instance()->GetInput()->GetFrame();
 }
 
 bool ActionData::IsNew() const { return m_StartTime == -1 && m_EndTime == -1; }
-bool ActionData::IsExpired() const {
-	return m_EndTime != -1 &&
-		   Engine::Instance()->GetTimeState()->GetTime() > m_EndTime;
-}
+bool ActionData::IsExpired() const { return m_EndTime != -1 && !IsStopped(); }
 
 bool ActionData::GetValue() const { return m_Value; }
 
 #define CHECK_VALID_SCANCODE(x) ASSERT(x < SDL_NUM_SCANCODES)
 
-Input::Input() {
-	// Ensure initialized to false/0
-	memset(m_KeyDown, false, sizeof m_KeyDown);
-}
+Input::Input()
+	: m_DroppedEvents(0),
+	  m_ReportedDroppedEvents(0),
+	  m_Frame(0),
+	  m_ChangeTimes(),
+	  m_ConsumedInputTime(0) {}
 
 bool Input::GetKey(int scancode) {
 	CHECK_VALID_SCANCODE(scancode);
-	return m_KeyDown[scancode];
+
+	if (m_ChangedKeys[scancode]) {
+		uint64_t changeTime = m_ChangeTimes[scancode];
+		if (m_ConsumedInputTime == 0 || changeTime < m_ConsumedInputTime) {
+			m_ConsumedInputTime = changeTime;
+		}
+	}
+
+	return m_Keys[scancode];
 }
 
-void Input::SetKeyUp(int scancode) {
+const ActionData& Input::GetAction(int scancode) const {
 	CHECK_VALID_SCANCODE(scancode);
-	m_KeyDown[scancode] = false;
+	return m_Actions[scancode];
+}
+
+void Input::Latch(uint64_t perfCounter) {
+	m_Frame++;
+	m_ChangedKeys.reset();
+
+	auto timeState = Engine::Instance()->GetTimeState();
+
+	// Any later events are left for the next frame
+	const KeyEvent* event;
+	while ((event = m_Events.Peek()) != nullptr &&
+		   event->perfCounter <= perfCounter) {
+		if (m_Keys[event->scancode] != event->down) {
+			if (!m_ChangedKeys[event->scancode]) {
+				m_ChangeTimes[event->scancode] = event->timestamp;
+			}
+
+			// Changing back within the frame isn't a change
+			m_ChangedKeys.flip(event->scancode);
+		}
+
+		SetKey(event->scancode, event->down,
+			   timeState->GetTimeAt(event->perfCounter));
+		m_Events.Pop();
+	}
+
+	uint64_t droppedEvents = m_DroppedEvents.load(std::memory_order_relaxed);
+	if (droppedEvents != m_ReportedDroppedEvents) {
+		std::cerr << "[Input]: Dropped "
+				  << droppedEvents - m_ReportedDroppedEvents
+				  << " key events, the queue was full!" << std::endl;
+		m_ReportedDroppedEvents = droppedEvents;
+	}
+}
+
+void Input::SetKeys(const KeyStates& keys, double time) {
+	m_Frame++;
+	m_ChangedKeys.reset();
+
+	for (size_t i = 0; i < SDL_NUM_SCANCODES; ++i) {
+		if (keys[i] != m_Keys[i]) SetKey(i, keys[i], time);
+	}
+}
+
+uint64_t Input::TakeConsumedInputTime() {
+	uint64_t time = m_ConsumedInputTime;
+	m_ConsumedInputTime = 0;
+	return time;
+}
+
+int SDLCALL Input::EventWatch(void* userdata, SDL_Event* event) {
+	if (event->type != SDL_KEYDOWN && event->type != SDL_KEYUP) return 1;
+	// Repeats don't change anything
+	if (event->key.repeat) return 1;
+
+	Input* input = static_cast<Input*>(userdata);
+
+	KeyEvent keyEvent = {FrameStats::Now(), SDL_GetPerformanceCounter(),
+						 event->key.keysym.scancode,
+						 event->type == SDL_KEYDOWN};
+	CHECK_VALID_SCANCODE(keyEvent.scancode);
+
+	if (!input->m_Events.TryPush(keyEvent)) {
+		input->m_DroppedEvents.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	return 1;
+}
+
+void Input::SetKey(int scancode, bool down, double time) {
+	m_Keys[scancode] = down;
+
+	if (down) {
+		m_Actions[scancode].Start(time, m_Frame);
+	} else {
+		m_Actions[scancode].Stop(time, m_Frame);
+	}
 }
-void Input::SetKeyDown(int scancode) {
-	CHECK_VALID_SCANCODE(scancode);
-	m_KeyDown[scancode] = true;
-}
\ No newline at end of file
@@ -2,23 +2,35 @@
 
 #include <SDL.h>
 
-// TODO: use template to make data generic?
+#include <atomic>
+#include <bitset>
+
+#include "config.h"
+#include "engine/types/spsc_ring.h"
+
+// Tracks the phases of an action (eg. a key being held), with the start + end
+// times being exactly when its events occurred rather than when they were
+// latched. So presses/releases are timed to within a fixed tick, and even taps
+// shorter than a frame are caught.
 class ActionData {
    public:
 	ActionData();
 
-	void Start(bool value);
-	void Stop(bool value);
+	// Times are in the time state's time, frames are the input latch count
+	void Start(double time, uint64_t frame);
+	void Stop(double time, uint64_t frame);
 
-	float GetStartTime() const;
-	float GetEndTime() const;
+	double GetStartTime() const;
+	double GetEndTime() const;
 
-	float GetDuration() const;
+	// How long it's been held so far, or was held for if it's stopped
+	double GetDuration() const;
 
 	bool IsHeld() const;
 
 	bool InPhase() const;
 
+	// Whether it started/stopped within the most recently latched input
 	bool IsStarted() const;
 	bool IsPerformed() const;
 	bool IsStopped() const;
@@ -30,19 +42,74 @@ class ActionData {
 
    private:
 	bool m_Value;
-	float m_StartTime;
-	float m_EndTime;
+	double m_StartTime;
+	double m_EndTime;
+	uint64_t m_StartFrame;
+	uint64_t m_EndFrame;
 };
 
+typedef std::bitset<SDL_NUM_SCANCODES> KeyStates;
+
+// Key events are captured by an SDL event watch as soon as they're pumped (by
+// the main thread), being timestamped + handed to the simulation thread through
+// a lock-free ring, so nothing locks and no presses are lost in between frames.
+// The simulation thread then latches them once per frame.
+
 class Input {
    public:
 	Input();
 
+	// Gets the key state latched at the start of the current frame
 	bool GetKey(int scancode);
+	const ActionData& GetAction(int scancode) const;
+
+	// Number of times the input has been latched
+	inline uint64_t GetFrame() const { return m_Frame; }
+
+	// Applies the key events which occurred by 'perfCounter' (see
+	// 'SDL_GetPerformanceCounter()') for the simulation thread to read this
+	// frame, so they're consistent throughout it (and can be recorded)
+	void Latch(uint64_t perfCounter);
+
+	inline const KeyStates& GetKeys() const { return m_Keys; }
+	// Overrides the latched key states (eg. when replaying a recording), with
+	// any changes happening at 'time'
+	void SetKeys(const KeyStates& keys, double time);
+
+	// Gets (+ resets) when the earliest key change read via 'GetKey()' since
+	// the last call was captured, 0 if none were read. Used to measure the
+	// latency from input to it being presented.
+	uint64_t TakeConsumedInputTime();
 
-	void SetKeyUp(int scancode);
-	void SetKeyDown(int scancode);
+	// Registered with 'SDL_AddEventWatch()', with this input as the user data
+	static int SDLCALL EventWatch(void* userdata, SDL_Event* event);
 
    private:
-	bool m_KeyDown[SDL_NUM_SCANCODES];
-};
\ No newline at end of file
+	struct KeyEvent {
+		// When captured (see 'FrameStats::Now()') + by SDL's counter
+		uint64_t timestamp;
+		uint64_t perfCounter;
+		int scancode;
+		bool down;
+	};
+
+	void SetKey(int scancode, bool down, double time);
+
+   private:
+	// Written by the main thread's event watch, read by the simulation thread
+	SpscRing<KeyEvent, Config::InputEventQueueSize> m_Events;
+	std::atomic<uint64_t> m_DroppedEvents;
+	uint64_t m_ReportedDroppedEvents;
+
+	// Only accessed by the simulation thread
+	uint64_t m_Frame;
+	KeyStates m_Keys;
+	ActionData m_Actions[SDL_NUM_SCANCODES];
+
+	// Keys which changed state when last latched, along with when the first
+	// event doing so was captured
+	KeyStates m_ChangedKeys;
+	uint64_t m_ChangeTimes[SDL_NUM_SCANCODES];
+
+	uint64_t m_ConsumedInputTime;
+};
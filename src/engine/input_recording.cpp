@@ -0,0 +1,141 @@
+#include "engine/input_recording.h"
+
+#include <cstring>
+#include <iostream>
+
+static constexpr char Magic[4] = {'T', 'D', 'I', 'R'};
+static constexpr uint32_t Version = 1;
+
+static constexpr uint8_t KeysChangedFlag = 0b1;
+static constexpr size_t KeyBytes = (SDL_NUM_SCANCODES + 7) / 8;
+
+static void WriteUint(std::ofstream& file, uint64_t value, int bytes) {
+	for (int i = 0; i < bytes; ++i) {
+		file.put((char)((value >> (i * 8)) & 0xFF));
+	}
+}
+
+static bool ReadUint(std::ifstream& file, uint64_t& value, int bytes) {
+	value = 0;
+	for (int i = 0; i < bytes; ++i) {
+		int byte = file.get();
+		if (byte == EOF) return false;
+		value |= (uint64_t)byte << (i * 8);
+	}
+
+	return true;
+}
+
+// LEB128, as the deltas are usually small
+static void WriteVarUint(std::ofstream& file, uint64_t value) {
+	do {
+		uint8_t byte = value & 0x7F;
+		value >>= 7;
+		if (value != 0) byte |= 0x80;
+		file.put((char)byte);
+	} while (value != 0);
+}
+
+static bool ReadVarUint(std::ifstream& file, uint64_t& value) {
+	value = 0;
+	for (int shift = 0; shift < 64; shift += 7) {
+		int byte = file.get();
+		if (byte == EOF) return false;
+
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) return true;
+	}
+
+	return false;
+}
+
+bool InputRecorder::Open(const std::string& path,
+						 const InputRecordingHeader& header) {
+	m_File.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_File.is_open()) {
+		std::cerr << "Couldn't open input recording file: '" << path << "'!"
+				  << std::endl;
+		return false;
+	}
+
+	m_File.write(Magic, sizeof(Magic));
+	WriteUint(m_File, Version, 4);
+	WriteUint(m_File, header.seed, 4);
+	WriteUint(m_File, header.perfFreq, 8);
+	WriteUint(m_File, header.levelPath.size(), 4);
+	m_File.write(header.levelPath.data(), header.levelPath.size());
+
+	m_LastKeys.reset();
+
+	return true;
+}
+
+void InputRecorder::WriteFrame(const InputRecordingFrame& frame) {
+	bool keysChanged = frame.keys != m_LastKeys;
+
+	m_File.put((char)(keysChanged ? KeysChangedFlag : 0));
+	WriteVarUint(m_File, frame.perfDelta);
+
+	if (keysChanged) {
+		uint8_t bytes[KeyBytes] = {};
+		for (size_t i = 0; i < SDL_NUM_SCANCODES; ++i) {
+			if (frame.keys[i]) bytes[i / 8] |= 1 << (i % 8);
+		}
+
+		m_File.write((const char*)bytes, KeyBytes);
+		m_LastKeys = frame.keys;
+	}
+}
+
+bool InputPlayer::Open(const std::string& path) {
+	m_File.open(path, std::ios::binary);
+	if (!m_File.is_open()) {
+		std::cerr << "Couldn't open input recording file: '" << path << "'!"
+				  << std::endl;
+		return false;
+	}
+
+	char magic[sizeof(Magic)];
+	uint64_t version, seed, levelPathLength;
+	if (!m_File.read(magic, sizeof(magic)) ||
+		std::memcmp(magic, Magic, sizeof(Magic)) != 0 ||
+		!ReadUint(m_File, version, 4) || version != Version ||
+		!ReadUint(m_File, seed, 4) ||
+		!ReadUint(m_File, m_Header.perfFreq, 8) ||
+		!ReadUint(m_File, levelPathLength, 4)) {
+		std::cerr << "Invalid input recording file: '" << path << "'!"
+				  << std::endl;
+		return false;
+	}
+
+	m_Header.seed = seed;
+	m_Header.levelPath.resize(levelPathLength);
+	if (!m_File.read(m_Header.levelPath.data(), levelPathLength) ||
+		m_Header.perfFreq == 0) {
+		std::cerr << "Invalid input recording file: '" << path << "'!"
+				  << std::endl;
+		return false;
+	}
+
+	m_LastKeys.reset();
+
+	return true;
+}
+
+bool InputPlayer::ReadFrame(InputRecordingFrame& frame) {
+	int flags = m_File.get();
+	if (flags == EOF || !ReadVarUint(m_File, frame.perfDelta)) return false;
+
+	if (flags & KeysChangedFlag) {
+		uint8_t bytes[KeyBytes];
+		if (!m_File.read((char*)bytes, KeyBytes)) return false;
+
+		for (size_t i = 0; i < SDL_NUM_SCANCODES; ++i) {
+			m_LastKeys[i] = (bytes[i / 8] >> (i % 8)) & 1;
+		}
+	}
+
+	frame.keys = m_LastKeys;
+
+	return true;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+#include "engine/input.h"
+
+// Records the input (and timing) of a run to a compact binary file so it can
+// be replayed identically later, eg. to compare performance before and after a
+// change using the exact same play through.
+//
+// The game samples keys during the variable update and the number of fixed
+// ticks per frame depends on the clock, so rather than per fixed tick the
+// recording stores for every frame the elapsed performance counter delta plus
+// the latched key states (only when they change). Along with the RNG seed and
+// level in the header, replaying these reproduces the same fixed ticks with the
+// same input.
+//
+// Layout (little endian):
+//   Header: "TDIR", u32 version, u32 seed, u64 perf frequency,
+//           u32 level path length, level path
+//   Frames: u8 flags, varint perf counter delta,
+//           [key bitset of SDL_NUM_SCANCODES bits if the keys changed]
+
+struct InputRecordingHeader {
+	uint32_t seed;
+	uint64_t perfFreq;
+	std::string levelPath;
+};
+
+struct InputRecordingFrame {
+	uint64_t perfDelta;
+	KeyStates keys;
+};
+
+class InputRecorder {
+   public:
+	bool Open(const std::string& path, const InputRecordingHeader& header);
+	void WriteFrame(const InputRecordingFrame& frame);
+
+   private:
+	std::ofstream m_File;
+	KeyStates m_LastKeys;
+};
+
+class InputPlayer {
+   public:
+	bool Open(const std::string& path);
+
+	// Returns false once the end of the recording is reached
+	bool ReadFrame(InputRecordingFrame& frame);
+
+	inline const InputRecordingHeader& GetHeader() const { return m_Header; }
+
+   private:
+	std::ifstream m_File;
+	InputRecordingHeader m_Header;
+	KeyStates m_LastKeys;
+};
@@ -0,0 +1,352 @@
+#include "engine/level_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define LEVEL_FILE_MMAP
+#endif
+
+static constexpr char Magic[4] = {'T', 'D', 'L', 'V'};
+static constexpr uint32_t Version = 1;
+
+static constexpr uint32_t CollidersFlag = 0b1;
+static constexpr size_t TileTypeBytes = 10;
+static constexpr size_t ColliderBytes = 9;
+
+static void WriteUint(std::string& data, uint64_t value, int bytes) {
+	for (int i = 0; i < bytes; ++i) {
+		data.push_back((char)((value >> (i * 8)) & 0xFF));
+	}
+}
+
+// LEB128, as most runs are short
+static void WriteVarUint(std::string& data, uint64_t value) {
+	do {
+		uint8_t byte = value & 0x7F;
+		value >>= 7;
+		if (value != 0) byte |= 0x80;
+		data.push_back((char)byte);
+	} while (value != 0);
+}
+
+// Reads from the file's data, advancing 'data' + failing past the end
+static bool ReadUint(const uint8_t*& data, const uint8_t* end, uint64_t& value,
+					 int bytes) {
+	if (end - data < bytes) return false;
+
+	value = 0;
+	for (int i = 0; i < bytes; ++i) {
+		value |= (uint64_t)data[i] << (i * 8);
+	}
+
+	data += bytes;
+	return true;
+}
+
+static bool ReadVarUint(const uint8_t*& data, const uint8_t* end,
+						uint64_t& value) {
+	value = 0;
+	for (int shift = 0; shift < 64 && data < end; shift += 7) {
+		uint8_t byte = *data++;
+
+		value |= (uint64_t)(byte & 0x7F) << shift;
+		if ((byte & 0x80) == 0) return true;
+	}
+
+	return false;
+}
+
+static bool InvalidFile(const std::string& path) {
+	std::cerr << "Invalid level file: '" << path << "'!" << std::endl;
+	return false;
+}
+
+// Read only mapping of a whole file, unmapped once it goes out of scope. Where
+// there's no mmap, the file is read into a buffer instead.
+class MappedFile {
+   public:
+	MappedFile() : m_Data(nullptr), m_Size(0) {}
+	~MappedFile() {
+#ifdef LEVEL_FILE_MMAP
+		if (m_Data != nullptr) munmap((void*)m_Data, m_Size);
+#endif
+	}
+
+	bool Open(const std::string& path) {
+#ifdef LEVEL_FILE_MMAP
+		int fd = open(path.c_str(), O_RDONLY);
+		if (fd < 0) return false;
+
+		struct stat info;
+		if (fstat(fd, &info) != 0 || info.st_size == 0) {
+			close(fd);
+			return false;
+		}
+
+		void* data =
+			mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		// The mapping stays valid without the descriptor
+		close(fd);
+		if (data == MAP_FAILED) return false;
+
+		// Rows are decoded front to back
+		madvise(data, info.st_size, MADV_SEQUENTIAL);
+
+		m_Data = (const uint8_t*)data;
+		m_Size = info.st_size;
+		return true;
+#else
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file.is_open()) return false;
+
+		std::streamsize size = file.tellg();
+		if (size <= 0) return false;
+
+		m_Buffer.resize(size);
+		file.seekg(0);
+		if (!file.read((char*)m_Buffer.data(), size)) return false;
+
+		m_Data = m_Buffer.data();
+		m_Size = m_Buffer.size();
+		return true;
+#endif
+	}
+
+	inline const uint8_t* GetData() const { return m_Data; }
+	inline const uint8_t* GetEnd() const { return m_Data + m_Size; }
+
+   private:
+	const uint8_t* m_Data;
+	size_t m_Size;
+
+#ifndef LEVEL_FILE_MMAP
+	std::vector<uint8_t> m_Buffer;
+#endif
+};
+
+bool LevelFile::Write(const std::string& path, const LevelData& level) {
+	if (level.width <= 0 || level.height <= 0 ||
+		level.width > MaxDimension || level.height > MaxDimension) {
+		std::cerr << "Level dimensions (" << level.width << 'x' << level.height
+				  << ") are out of range!" << std::endl;
+		return false;
+	}
+
+	std::string data;
+	data.append(Magic, sizeof(Magic));
+	WriteUint(data, Version, 4);
+	WriteUint(data, level.width, 4);
+	WriteUint(data, level.height, 4);
+	WriteUint(data, level.chunkSize > 0 ? CollidersFlag : 0, 4);
+	WriteUint(data, level.chunkSize, 4);
+
+	WriteUint(data, level.tileTypes.size(), 4);
+	for (const TileType& type : level.tileTypes) {
+		WriteUint(data, (uint8_t)type.renderMode, 1);
+		data.append((const char*)&type.fillColor, 4);
+		data.append((const char*)&type.outlineColor, 4);
+		WriteUint(data, type.collisionLayer, 1);
+	}
+
+	// Encode the rows first, to know where each starts
+	std::string rows;
+	std::vector<uint32_t> rowOffsets;
+	rowOffsets.reserve(level.height + 1);
+	for (int y = 0; y < level.height; ++y) {
+		rowOffsets.push_back(rows.size());
+
+		const uint8_t* row = &level.tiles[y * level.width];
+		for (int x = 0; x < level.width;) {
+			int runEnd = x + 1;
+			while (runEnd < level.width && row[runEnd] == row[x]) runEnd++;
+
+			WriteVarUint(rows, runEnd - x);
+			rows.push_back((char)row[x]);
+			x = runEnd;
+		}
+	}
+	rowOffsets.push_back(rows.size());
+
+	for (uint32_t offset : rowOffsets) WriteUint(data, offset, 4);
+	data.append(rows);
+
+	if (level.chunkSize > 0) {
+		for (uint32_t offset : level.chunkOffsets) WriteUint(data, offset, 4);
+
+		for (const TileCollider& collider : level.colliders) {
+			WriteUint(data, collider.x, 2);
+			WriteUint(data, collider.y, 2);
+			WriteUint(data, collider.width, 2);
+			WriteUint(data, collider.height, 2);
+			WriteUint(data, collider.collisionLayer, 1);
+		}
+	}
+
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open() || !file.write(data.data(), data.size())) {
+		std::cerr << "Couldn't write level file: '" << path << "'!"
+				  << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool LevelFile::Read(const std::string& path, LevelData& level) {
+	MappedFile file;
+	if (!file.Open(path)) {
+		std::cerr << "Couldn't load level file: '" << path << "'!" << std::endl;
+		return false;
+	}
+
+	const uint8_t* data = file.GetData();
+	const uint8_t* end = file.GetEnd();
+
+	if (end - data < (ptrdiff_t)sizeof(Magic) ||
+		std::memcmp(data, Magic, sizeof(Magic)) != 0) {
+		return InvalidFile(path);
+	}
+	data += sizeof(Magic);
+
+	uint64_t version, width, height, flags, chunkSize, tileTypeCount;
+	if (!ReadUint(data, end, version, 4) || version != Version ||
+		!ReadUint(data, end, width, 4) ||
+		!ReadUint(data, end, height, 4) || !ReadUint(data, end, flags, 4) ||
+		!ReadUint(data, end, chunkSize, 4) ||
+		!ReadUint(data, end, tileTypeCount, 4) || width == 0 ||
+		height == 0 || width > MaxDimension || height > MaxDimension ||
+		tileTypeCount == 0 || tileTypeCount > 256 ||
+		(size_t)(end - data) < tileTypeCount * TileTypeBytes) {
+		return InvalidFile(path);
+	}
+
+	level.width = width;
+	level.height = height;
+
+	level.tileTypes.resize(tileTypeCount);
+	for (TileType& type : level.tileTypes) {
+		type.renderMode = (RenderMode)data[0];
+		std::memcpy(&type.fillColor, data + 1, 4);
+		std::memcpy(&type.outlineColor, data + 5, 4);
+		type.collisionLayer = data[9];
+
+		if (type.renderMode > RenderMode::Both) {
+			return InvalidFile(path);
+		}
+
+		data += TileTypeBytes;
+	}
+
+	const uint8_t* rowOffsets = data;
+	const uint8_t* rows = data + (height + 1) * 4;
+	if (rows > end) {
+		return InvalidFile(path);
+	}
+
+	// Decode the runs straight into the tiles, there's no other copy
+	level.tiles.resize(width * height);
+	uint8_t* tile = level.tiles.data();
+	data = rows;
+	for (uint64_t y = 0; y < height; ++y) {
+		uint64_t rowOffset;
+		ReadUint(rowOffsets, end, rowOffset, 4);
+		if (data != rows + rowOffset) {
+			return InvalidFile(path);
+		}
+
+		for (uint64_t x = 0; x < width;) {
+			uint64_t runLength;
+			if (!ReadVarUint(data, end, runLength) || data == end ||
+				runLength == 0 || runLength > width - x ||
+				*data >= tileTypeCount) {
+				return InvalidFile(path);
+			}
+
+			std::memset(tile, *data++, runLength);
+			tile += runLength;
+			x += runLength;
+		}
+	}
+
+	uint64_t rowsEnd;
+	ReadUint(rowOffsets, end, rowsEnd, 4);
+	if (data != rows + rowsEnd) {
+		return InvalidFile(path);
+	}
+
+	level.chunkSize = 0;
+	level.colliders.clear();
+	level.chunkOffsets.clear();
+	if ((flags & CollidersFlag) == 0) return true;
+
+	if (chunkSize == 0 || chunkSize > MaxDimension) {
+		return InvalidFile(path);
+	}
+
+	uint64_t chunkCount = ((width + chunkSize - 1) / chunkSize) *
+						  ((height + chunkSize - 1) / chunkSize);
+	level.chunkOffsets.resize(chunkCount + 1);
+	for (size_t i = 0; i < level.chunkOffsets.size(); ++i) {
+		uint64_t offset;
+		// Offsets must never go backwards
+		if (!ReadUint(data, end, offset, 4) ||
+			(i > 0 && offset < level.chunkOffsets[i - 1])) {
+			return InvalidFile(path);
+		}
+
+		level.chunkOffsets[i] = offset;
+	}
+
+	uint64_t colliderCount = level.chunkOffsets.back();
+	if (level.chunkOffsets.front() != 0 ||
+		(size_t)(end - data) != colliderCount * ColliderBytes) {
+		return InvalidFile(path);
+	}
+
+	level.colliders.resize(colliderCount);
+	for (TileCollider& collider : level.colliders) {
+		uint64_t x, y, colliderWidth, colliderHeight, collisionLayer;
+		ReadUint(data, end, x, 2);
+		ReadUint(data, end, y, 2);
+		ReadUint(data, end, colliderWidth, 2);
+		ReadUint(data, end, colliderHeight, 2);
+		ReadUint(data, end, collisionLayer, 1);
+
+		if (x + colliderWidth > width || y + colliderHeight > height) {
+			return InvalidFile(path);
+		}
+
+		collider = {(uint16_t)x, (uint16_t)y, (uint16_t)colliderWidth,
+					(uint16_t)colliderHeight, (uint8_t)collisionLayer};
+	}
+
+	level.chunkSize = chunkSize;
+	return true;
+}
+
+void LevelFile::MergeColliders(LevelData& level, int chunkSize) {
+	level.chunkSize = chunkSize;
+	level.colliders.clear();
+	level.chunkOffsets.clear();
+
+	for (int y = 0; y < level.height; y += chunkSize) {
+		for (int x = 0; x < level.width; x += chunkSize) {
+			level.chunkOffsets.push_back(level.colliders.size());
+
+			TileMap::MergeColliders(
+				level.width, level.tileTypes, level.tiles.data(), x, y,
+				std::min(x + chunkSize, level.width) - 1,
+				std::min(y + chunkSize, level.height) - 1, level.colliders);
+		}
+	}
+
+	level.chunkOffsets.push_back(level.colliders.size());
+}
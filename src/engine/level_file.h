@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "engine/components/tilemap.h"
+
+// Compiled levels, so large tile maps load straight from a memory mapped file
+// (where supported, otherwise it's read into a buffer), decoding each row's
+// runs directly into the tile map's storage, rather than being parsed from
+// text. The colliding tiles can also be merged ahead of time into rectangles
+// per chunk (see 'TileCollider'), rather than when the level is loaded.
+//
+// Each row is run length encoded, with the row offsets stored up front so any
+// row can be decoded without the ones before it.
+//
+// Layout (little endian):
+//   Header:     "TDLV", u32 version, u32 width, u32 height, u32 flags,
+//               u32 chunk size (0 without colliders)
+//   Tile types: u32 count, then per type u8 render mode, u8[4] fill color,
+//               u8[4] outline color, u8 collision layer
+//   Rows:       u32 offset of each row (+ the end) from the first row, then
+//               per row runs of varint length, u8 tile
+//   Colliders:  (if flagged) u32 offset of each chunk's colliders (+ the end),
+//               then per collider u16 x, u16 y, u16 width, u16 height,
+//               u8 collision layer
+
+struct LevelData {
+	int width = 0;
+	int height = 0;
+
+	std::vector<TileType> tileTypes;
+	// Row major, indexing into the tile types
+	std::vector<uint8_t> tiles;
+
+	// 0 if the colliders haven't been merged
+	int chunkSize = 0;
+	std::vector<TileCollider> colliders;
+	std::vector<uint32_t> chunkOffsets;
+};
+
+class LevelFile {
+   public:
+	// Largest width/height, as colliders store cells in 16 bits
+	static constexpr int MaxDimension = UINT16_MAX;
+
+	static bool Write(const std::string& path, const LevelData& level);
+	static bool Read(const std::string& path, LevelData& level);
+
+	// Merges the colliding tiles within each chunk (see
+	// 'TileMap::MergeColliders()'), so they're ready as soon as it's loaded
+	static void MergeColliders(LevelData& level, int chunkSize);
+};
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstdint>
 
 // Various helper functions related to maths
 
@@ -14,10 +15,30 @@ class MathUtils {
 		return (zeroToOne * (max - min)) + min;
 	}
 
+	// Deterministic random numbers (xorshift32), so runs using the same seed
+	// (eg. replays) play out identically. Only used by the simulation thread.
+	inline static void SetRandomSeed(uint32_t seed) {
+		// Xorshift never leaves a zero state
+		m_RandomState = seed != 0 ? seed : 1;
+	}
+
+	inline static uint32_t Random() {
+		m_RandomState ^= m_RandomState << 13;
+		m_RandomState ^= m_RandomState >> 17;
+		m_RandomState ^= m_RandomState << 5;
+		return m_RandomState;
+	}
+
+	// Random float within [0, 1)
+	inline static float RandomFloat() { return (Random() >> 8) * 0x1.0p-24f; }
+
 	inline static int RandomInt(int min, int max) {
-		return (rand() % (max - min)) + min;
+		return (Random() % (max - min)) + min;
 	}
 
 	static constexpr double RadToDeg = 180 / M_PI;
 	static constexpr double DegToRad = M_PI / 180;
+
+   private:
+	inline static uint32_t m_RandomState = 1;
 };
\ No newline at end of file
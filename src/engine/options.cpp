@@ -0,0 +1,256 @@
+#include "engine/options.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+static void PrintUsage(const char* program) {
+	std::cerr << "Usage: " << program
+			  << " [--headless] [--ticks N] [--seed N] [--level PATH]"
+				 " [--renderer accelerated|software] [--dump-every N]"
+				 " [--dump-dir PATH] [--record PATH | --replay PATH]"
+				 " [--hash-out PATH] [--profile-trace PATH]"
+				 " [--profile-csv PATH] [--frame-budget MS]"
+				 " [--hitch-out PATH] [--perf-counters] [--perf-csv PATH]"
+				 " [--max-frame-allocs N] [--pacing vsync|target|jit]"
+				 " [--target-fps N]"
+				 "\n       "
+			  << program << " --hash-diff PATH_A PATH_B"
+			  << "\n       " << program
+			  << " --convert-level TEXT_PATH LEVEL_PATH" << std::endl;
+}
+
+// Parses 'value' as an unsigned integer, returns false if it isn't one
+static bool ParseUnsigned(const char* value, uint64_t& result) {
+	if (value == nullptr || *value == '\0') return false;
+
+	char* end;
+	result = std::strtoull(value, &end, 10);
+	return *end == '\0' && value[0] != '-';
+}
+
+bool EngineOptions::Parse(int argc, char* argv[], EngineOptions& options) {
+	bool hasTargetFps = false;
+
+	for (int i = 1; i < argc; ++i) {
+		const char* arg = argv[i];
+		const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+
+		if (std::strcmp(arg, "--headless") == 0) {
+			options.headless = true;
+			continue;
+		}
+
+		if (std::strcmp(arg, "--perf-counters") == 0) {
+			options.perfCounters = true;
+			continue;
+		}
+
+		if (std::strcmp(arg, "--ticks") == 0) {
+			if (!ParseUnsigned(value, options.ticks)) {
+				std::cerr << "Invalid tick count: '" << (value ? value : "")
+						  << "'" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+		} else if (std::strcmp(arg, "--seed") == 0) {
+			uint64_t seed;
+			if (!ParseUnsigned(value, seed) || seed > UINT32_MAX) {
+				std::cerr << "Invalid seed: '" << (value ? value : "") << "'"
+						  << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.seed = seed;
+		} else if (std::strcmp(arg, "--level") == 0) {
+			if (value == nullptr) {
+				std::cerr << "Missing level path" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.levelPath = value;
+		} else if (std::strcmp(arg, "--renderer") == 0) {
+			if (value != nullptr && std::strcmp(value, "accelerated") == 0) {
+				options.renderBackend = RenderBackend::Accelerated;
+			} else if (value != nullptr &&
+					   std::strcmp(value, "software") == 0) {
+				options.renderBackend = RenderBackend::Software;
+			} else {
+				std::cerr << "Invalid renderer: '" << (value ? value : "")
+						  << "'" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+		} else if (std::strcmp(arg, "--pacing") == 0) {
+			if (value != nullptr && std::strcmp(value, "vsync") == 0) {
+				options.pacing = PacingMode::VSync;
+			} else if (value != nullptr && std::strcmp(value, "target") == 0) {
+				options.pacing = PacingMode::Target;
+			} else if (value != nullptr && std::strcmp(value, "jit") == 0) {
+				options.pacing = PacingMode::JustInTime;
+			} else {
+				std::cerr << "Invalid pacing mode: '" << (value ? value : "")
+						  << "'" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+		} else if (std::strcmp(arg, "--target-fps") == 0) {
+			char* end = nullptr;
+			double fps = value ? std::strtod(value, &end) : 0.0;
+			if (value == nullptr || *end != '\0' || !(fps > 0.0)) {
+				std::cerr << "Invalid target frame rate: '"
+						  << (value ? value : "") << "'" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.targetFps = fps;
+			hasTargetFps = true;
+		} else if (std::strcmp(arg, "--dump-every") == 0) {
+			if (!ParseUnsigned(value, options.dumpEvery)) {
+				std::cerr << "Invalid dump interval: '" << (value ? value : "")
+						  << "'" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+		} else if (std::strcmp(arg, "--dump-dir") == 0) {
+			if (value == nullptr) {
+				std::cerr << "Missing dump directory" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.dumpDir = value;
+		} else if (std::strcmp(arg, "--record") == 0) {
+			if (value == nullptr) {
+				std::cerr << "Missing recording path" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.recordPath = value;
+		} else if (std::strcmp(arg, "--replay") == 0) {
+			if (value == nullptr) {
+				std::cerr << "Missing replay path" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.replayPath = value;
+		} else if (std::strcmp(arg, "--hash-out") == 0) {
+			if (value == nullptr) {
+				std::cerr << "Missing state hash path" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.hashOutPath = value;
+		} else if (std::strcmp(arg, "--profile-trace") == 0) {
+			if (value == nullptr) {
+				std::cerr << "Missing profiler trace path" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.profileTracePath = value;
+		} else if (std::strcmp(arg, "--profile-csv") == 0) {
+			if (value == nullptr) {
+				std::cerr << "Missing profiler CSV path" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.profileCsvPath = value;
+		} else if (std::strcmp(arg, "--frame-budget") == 0) {
+			char* end = nullptr;
+			double budget = value ? std::strtod(value, &end) : 0.0;
+			if (value == nullptr || *end != '\0' || !(budget > 0.0)) {
+				std::cerr << "Invalid frame budget: '" << (value ? value : "")
+						  << "'" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.frameBudget = budget;
+		} else if (std::strcmp(arg, "--hitch-out") == 0) {
+			if (value == nullptr) {
+				std::cerr << "Missing hitch path" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.hitchPath = value;
+		} else if (std::strcmp(arg, "--perf-csv") == 0) {
+			if (value == nullptr) {
+				std::cerr << "Missing performance counter path" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.perfCounters = true;
+			options.perfCsvPath = value;
+		} else if (std::strcmp(arg, "--max-frame-allocs") == 0) {
+			if (!ParseUnsigned(value, options.maxFrameAllocs)) {
+				std::cerr << "Invalid allocation limit: '"
+						  << (value ? value : "") << "'" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+		} else if (std::strcmp(arg, "--hash-diff") == 0) {
+			if (value == nullptr || i + 2 >= argc) {
+				std::cerr << "Missing state hash paths to compare" << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.hashDiffPaths[0] = value;
+			options.hashDiffPaths[1] = argv[i + 2];
+
+			// Skip the extra value
+			++i;
+		} else if (std::strcmp(arg, "--convert-level") == 0) {
+			if (value == nullptr || i + 2 >= argc) {
+				std::cerr << "Missing level paths to convert between"
+						  << std::endl;
+				PrintUsage(argv[0]);
+				return false;
+			}
+			options.convertLevelPaths[0] = value;
+			options.convertLevelPaths[1] = argv[i + 2];
+
+			// Skip the extra value
+			++i;
+		} else {
+			std::cerr << "Unknown argument: '" << arg << "'" << std::endl;
+			PrintUsage(argv[0]);
+			return false;
+		}
+
+		// Skip the value
+		++i;
+	}
+
+	if (!options.recordPath.empty() && !options.replayPath.empty()) {
+		std::cerr << "Can't record whilst replaying" << std::endl;
+		return false;
+	}
+
+#ifndef ENABLE_PROFILER
+	if (!options.profileTracePath.empty() || !options.profileCsvPath.empty()) {
+		std::cerr << "Built without the profiler (ENABLE_PROFILER)"
+				  << std::endl;
+		return false;
+	}
+#endif
+
+	if (hasTargetFps && options.pacing == PacingMode::VSync) {
+		std::cerr << "A target frame rate requires '--pacing target|jit'"
+				  << std::endl;
+		return false;
+	}
+
+#ifndef ENABLE_ALLOC_TRACKING
+	if (options.maxFrameAllocs > 0) {
+		std::cerr << "Built without allocation tracking (ENABLE_ALLOC_TRACKING)"
+				  << std::endl;
+		return false;
+	}
+#endif
+
+	if ((options.dumpEvery > 0 || !options.dumpDir.empty()) &&
+		options.renderBackend != RenderBackend::Software) {
+		std::cerr << "Frame dumps require '--renderer software'" << std::endl;
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "engine/frame_pacer.h"
+
+// Options for how the engine should run, parsed from the command line
+//
+// Usage: game [--headless] [--ticks N] [--seed N] [--level PATH]
+//             [--renderer accelerated|software] [--dump-every N]
+//             [--dump-dir PATH] [--record PATH | --replay PATH]
+//             [--hash-out PATH] [--profile-trace PATH] [--profile-csv PATH]
+//             [--frame-budget MS] [--hitch-out PATH] [--perf-counters]
+//             [--perf-csv PATH] [--max-frame-allocs N]
+//             [--pacing vsync|target|jit] [--target-fps N]
+//        game --hash-diff PATH_A PATH_B
+//        game --convert-level TEXT_PATH LEVEL_PATH
+//
+// Headless mode skips creating a window and drives the simulation off a
+// virtual clock which advances exactly one fixed time step per tick, so it
+// runs as fast as possible (eg. for soak testing or benchmarking on build
+// agents without a display). Render ops are still generated, but are only
+// drawn if the software renderer is also selected.
+//
+// Without vsync the simulation is paced to the target frame rate instead (see
+// 'frame_pacer.h'), trading tearing for lower input latency. Pacing is ignored
+// when headless.
+//
+// The software renderer draws into an offscreen surface using SDL's dummy
+// video driver, so rendering can be measured (and its output checked for
+// regressions via the frame dumps) on machines without a GPU or display.
+//
+// Runs can be recorded and replayed (see 'input_recording.h'), replays use the
+// recorded seed + level and quit once the recording ends. The simulation's
+// state can also be hashed every fixed tick (see 'state_hash.h') and two such
+// hash streams compared, without running the game, via '--hash-diff'.
+//
+// Levels can be compiled from text via '--convert-level' (see 'level_file.h'),
+// which is worth doing for large maps as they load far faster. Any '--level'
+// ending in '.lvl' is loaded as a compiled level, otherwise as text.
+//
+// If built with the profiler (see 'profiler.h'), its recorded scopes are
+// exported on exit to a Chrome trace and/or per frame CSV.
+//
+// Frame time percentiles are always reported on exit (see 'frame_stats.h'),
+// and frames exceeding the budget (if set) dump their recent history. The
+// budget is also what the frame governor (see 'frame_governor.h') measures the
+// simulation's load against.
+//
+// Hardware performance counters can also be reported per stage (see
+// 'perf_counters.h'), with '--perf-csv' writing them for every frame.
+//
+// If built with allocation tracking (see 'alloc_tracker.h'), the allocations
+// are reported on exit, failing the run if any steady state frame made more
+// than '--max-frame-allocs'.
+
+enum class RenderBackend {
+	Accelerated,
+	Software,
+};
+
+struct EngineOptions {
+	bool headless = false;
+	RenderBackend renderBackend = RenderBackend::Accelerated;
+
+	PacingMode pacing = PacingMode::VSync;
+	// Only used without vsync
+	double targetFps = 60.0;
+
+	// Prints a checksum of every N-th presented frame (software renderer
+	// only), 0 disables dumping
+	uint64_t dumpEvery = 0;
+	// Also saves the dumped frames as bitmaps within this directory if set
+	std::string dumpDir;
+
+	std::string recordPath;
+	std::string replayPath;
+
+	std::string hashOutPath;
+	std::string hashDiffPaths[2];
+
+	inline bool IsHashDiff() const { return !hashDiffPaths[0].empty(); }
+
+	// Compiles a text level into a binary one (see 'level_file.h')
+	std::string convertLevelPaths[2];
+
+	inline bool IsLevelConversion() const {
+		return !convertLevelPaths[0].empty();
+	}
+
+	std::string profileTracePath;
+	std::string profileCsvPath;
+
+	// Milliseconds, 0 disables capturing hitches
+	double frameBudget = 0.0;
+	std::string hitchPath = "hitches.csv";
+
+	bool perfCounters = false;
+	std::string perfCsvPath;
+
+	// Most allocations a steady state frame may make before failing the run
+	// (allocation tracking only), 0 disables the check
+	uint64_t maxFrameAllocs = 0;
+
+	// Number of fixed ticks to run before stopping, 0 runs until quit
+	uint64_t ticks = 0;
+
+	uint32_t seed = 1;
+	std::string levelPath = "levels/level3.txt";
+
+	// Returns false (after printing the usage) if the arguments are invalid
+	static bool Parse(int argc, char* argv[], EngineOptions& options);
+};
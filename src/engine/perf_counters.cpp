@@ -0,0 +1,291 @@
+#include "engine/perf_counters.h"
+
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+#include "engine/engine.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+static const char* GetCounterName(int counter) {
+	switch (counter) {
+		case PerfCounter::Cycles:
+			return "cycles";
+		case PerfCounter::Instructions:
+			return "instructions";
+		case PerfCounter::L1DMisses:
+			return "l1d_misses";
+		case PerfCounter::LLCMisses:
+			return "llc_misses";
+		case PerfCounter::BranchMisses:
+			return "branch_misses";
+		default:
+			return "unknown";
+	}
+}
+
+static const char* GetSectionName(int section) {
+	if (section == PerfCounters::PhysicsSection) return "Physics";
+	return GetEngineStageName((EngineStage)section);
+}
+
+PerfCounters::PerfCounters(const std::string& csvPath)
+	: m_LeaderFd(-1),
+	  m_GroupSize(0),
+	  m_LastReading({}),
+	  m_Section((int)EngineStage::Run),
+	  m_InFrame(false),
+	  m_FrameCount(0),
+	  m_FrameTotals(),
+	  m_Totals(),
+	  m_CsvPath(csvPath) {
+	for (int i = 0; i < PerfCounterCount; ++i) {
+		m_Fds[i] = -1;
+		m_GroupIndex[i] = -1;
+	}
+}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+	for (int fd : m_Fds) {
+		if (fd != -1) close(fd);
+	}
+#endif
+}
+
+#ifdef __linux__
+static int OpenCounter(uint32_t type, uint64_t config, int groupFd) {
+	perf_event_attr attr;
+	std::memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	// The whole group is enabled at once via the leader
+	attr.disabled = groupFd == -1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+					   PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+	// Counts the calling thread on any CPU
+	return syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0);
+}
+#endif
+
+bool PerfCounters::Open() {
+#ifdef __linux__
+	struct CounterConfig {
+		uint32_t type;
+		uint64_t config;
+	};
+
+	const CounterConfig configs[PerfCounterCount] = {
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+		{PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+								 (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+								 (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+		{PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+	};
+
+	for (int i = 0; i < PerfCounterCount; ++i) {
+		int fd = OpenCounter(configs[i].type, configs[i].config, m_LeaderFd);
+		if (fd == -1) {
+			// Without cycles (the group leader) there's nothing to go on
+			if (i == PerfCounter::Cycles) {
+				std::cerr << "Hardware performance counters unavailable: "
+						  << std::strerror(errno) << std::endl;
+				return false;
+			}
+
+			std::cerr << "Performance counter '" << GetCounterName(i)
+					  << "' unavailable: " << std::strerror(errno)
+					  << std::endl;
+			continue;
+		}
+
+		if (m_LeaderFd == -1) m_LeaderFd = fd;
+		m_Fds[i] = fd;
+		m_GroupIndex[i] = m_GroupSize++;
+	}
+
+	ioctl(m_LeaderFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(m_LeaderFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+
+	Read(m_LastReading);
+
+	if (!m_CsvPath.empty()) {
+		m_CsvFile.open(m_CsvPath, std::ios::trunc);
+		if (m_CsvFile.is_open()) {
+			WriteCsvHeader();
+		} else {
+			std::cerr << "Couldn't open performance counter file: '"
+					  << m_CsvPath << "'!" << std::endl;
+		}
+	}
+
+	return true;
+#else
+	std::cerr << "Hardware performance counters are only supported on Linux"
+			  << std::endl;
+	return false;
+#endif
+}
+
+bool PerfCounters::Read(Reading& reading) {
+#ifdef __linux__
+	// Layout of a group read with the enabled + running times
+	uint64_t buffer[3 + PerfCounterCount];
+	if (read(m_LeaderFd, buffer, sizeof(buffer)) <
+		(ssize_t)((3 + m_GroupSize) * sizeof(uint64_t))) {
+		return false;
+	}
+
+	reading.enabled = buffer[1];
+	reading.running = buffer[2];
+	for (int i = 0; i < PerfCounterCount; ++i) {
+		reading.counts.values[i] =
+			m_GroupIndex[i] == -1 ? 0 : buffer[3 + m_GroupIndex[i]];
+	}
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+int PerfCounters::Sample(int section) {
+	int previous = m_Section;
+	m_Section = section;
+
+	if (!IsOpen()) return previous;
+
+	Reading reading;
+	if (!Read(reading)) return previous;
+
+	if (m_InFrame) {
+		// Scale up if the group was multiplexed with others since the last
+		// sample. The raw counts only ever grow, unlike counts scaled by the
+		// cumulative ratio, which can drop when the ratio changes.
+		uint64_t enabled = reading.enabled - m_LastReading.enabled;
+		uint64_t running = reading.running - m_LastReading.running;
+		double scale = running > 0 && running < enabled
+						   ? (double)enabled / running
+						   : 1.0;
+
+		for (int i = 0; i < PerfCounterCount; ++i) {
+			uint64_t delta = (reading.counts.values[i] -
+							  m_LastReading.counts.values[i]) *
+							 scale;
+			m_FrameTotals[previous].values[i] += delta;
+			m_Totals[previous].values[i] += delta;
+		}
+	}
+
+	m_LastReading = reading;
+
+	return previous;
+}
+
+void PerfCounters::BeginFrame() {
+	Sample(m_Section);
+
+	for (auto& frameTotals : m_FrameTotals) {
+		frameTotals = {};
+	}
+	m_InFrame = true;
+}
+
+void PerfCounters::EndFrame() {
+	Sample(m_Section);
+	m_InFrame = false;
+
+	if (m_CsvFile.is_open()) {
+		m_CsvFile << m_FrameCount;
+		for (const auto& frameTotals : m_FrameTotals) {
+			for (uint64_t value : frameTotals.values) {
+				m_CsvFile << "," << value;
+			}
+		}
+		m_CsvFile << "\n";
+	}
+
+	m_FrameCount++;
+}
+
+void PerfCounters::WriteCsvHeader() {
+	m_CsvFile << "frame";
+	for (int section = 0; section < SectionCount; ++section) {
+		for (int i = 0; i < PerfCounterCount; ++i) {
+			m_CsvFile << "," << GetSectionName(section) << "_"
+					  << GetCounterName(i);
+		}
+	}
+	m_CsvFile << "\n";
+}
+
+void PerfCounters::Report(std::ostream& stream) const {
+	if (!IsOpen() || m_FrameCount == 0) return;
+
+	std::ios::fmtflags flags = stream.flags();
+	std::streamsize precision = stream.precision();
+
+	stream << std::fixed << std::setprecision(2);
+	stream << "[Perf Counters]: " << m_FrameCount
+		   << " frames, per frame averages (misses per 1k instructions)"
+		   << std::endl;
+	stream << "  " << std::left << std::setw(18) << "Section" << std::right
+		   << std::setw(14) << "Cycles" << std::setw(14) << "Instructions"
+		   << std::setw(8) << "IPC" << std::setw(10) << "L1D" << std::setw(10)
+		   << "LLC" << std::setw(10) << "Branch" << std::endl;
+
+	for (int section = 0; section < SectionCount; ++section) {
+		const Counts& totals = m_Totals[section];
+		if (totals.values[PerfCounter::Cycles] == 0) continue;
+
+		double instructions = totals.values[PerfCounter::Instructions];
+		auto perKiloInstr = [&](int counter) {
+			return instructions > 0
+					   ? totals.values[counter] * 1000.0 / instructions
+					   : 0.0;
+		};
+
+		stream << "  " << std::left << std::setw(18)
+			   << GetSectionName(section) << std::right << std::setw(14)
+			   << totals.values[PerfCounter::Cycles] / m_FrameCount
+			   << std::setw(14) << (uint64_t)instructions / m_FrameCount
+			   << std::setw(8)
+			   << instructions / totals.values[PerfCounter::Cycles];
+
+		for (int counter : {PerfCounter::L1DMisses, PerfCounter::LLCMisses,
+							PerfCounter::BranchMisses}) {
+			if (m_GroupIndex[counter] == -1) {
+				stream << std::setw(10) << "n/a";
+			} else {
+				stream << std::setw(10) << perKiloInstr(counter);
+			}
+		}
+		stream << std::endl;
+	}
+
+	stream.flags(flags);
+	stream.precision(precision);
+}
+
+PerfCountersScope::PerfCountersScope(PerfCounters* counters, int section)
+	: m_Counters(counters), m_PreviousSection(-1) {
+	if (m_Counters != nullptr) m_PreviousSection = m_Counters->Sample(section);
+}
+
+PerfCountersScope::~PerfCountersScope() {
+	if (m_Counters != nullptr) m_Counters->Sample(m_PreviousSection);
+}
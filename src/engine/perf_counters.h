@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+
+#include "engine/engine_stage.h"
+
+// Hardware performance counters (via Linux's 'perf_event_open') for the
+// simulation thread, sampled at every engine stage transition and around the
+// physics update. Each sample's delta is attributed to the section that was
+// running, so the counters show whether a section is bound by cache misses,
+// branch mispredicts etc. rather than just that it's slow.
+//
+// Counters are often unavailable (eg. other platforms, containers or a
+// restrictive 'perf_event_paranoid'), in which case opening fails and the
+// engine carries on without them. Individual counters the CPU doesn't support
+// are reported as unavailable.
+
+enum PerfCounter {
+	Cycles,
+	Instructions,
+	L1DMisses,
+	LLCMisses,
+	BranchMisses,
+	PerfCounterCount,
+};
+
+class PerfCounters {
+   public:
+	// Sections are the engine stages followed by the extra ones below
+	static constexpr int PhysicsSection = EngineStageCount;
+	static constexpr int SectionCount = EngineStageCount + 1;
+
+	PerfCounters(const std::string& csvPath);
+	~PerfCounters();
+
+	// Opens the counters for the calling thread, returns false (after
+	// printing why) if they're unavailable
+	bool Open();
+	inline bool IsOpen() const { return m_LeaderFd != -1; }
+
+	// Attributes the counts since the last sample to the current section,
+	// then switches to 'section'. Returns the previous section.
+	int Sample(int section);
+
+	void BeginFrame();
+	void EndFrame();
+
+	void Report(std::ostream& stream) const;
+
+   private:
+	struct Counts {
+		uint64_t values[PerfCounterCount];
+	};
+
+	// Raw (unscaled) counts, with how long the group was enabled + running
+	struct Reading {
+		Counts counts;
+		uint64_t enabled;
+		uint64_t running;
+	};
+
+	bool Read(Reading& reading);
+
+	void WriteCsvHeader();
+
+   private:
+	int m_LeaderFd;
+	int m_Fds[PerfCounterCount];
+	// Index within the group read of each counter, -1 if unavailable
+	int m_GroupIndex[PerfCounterCount];
+	int m_GroupSize;
+
+	Reading m_LastReading;
+	int m_Section;
+	bool m_InFrame;
+
+	uint64_t m_FrameCount;
+	Counts m_FrameTotals[SectionCount];
+	Counts m_Totals[SectionCount];
+
+	std::string m_CsvPath;
+	std::ofstream m_CsvFile;
+};
+
+// Samples a section for the lifetime of the scope (if the counters are open)
+class PerfCountersScope {
+   public:
+	PerfCountersScope(PerfCounters* counters, int section);
+	~PerfCountersScope();
+
+   private:
+	PerfCounters* m_Counters;
+	int m_PreviousSection;
+};
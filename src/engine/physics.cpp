@@ -4,8 +4,11 @@
 #include <iostream>
 
 #include "config.h"
+#include "engine/alloc_tracker.h"
+#include "engine/components/tilemap.h"
 #include "engine/engine.h"
 #include "engine/entity.h"
+#include "engine/profiler.h"
 
 void AABB::GetMinMax(Vec2& min, Vec2& max) const {
 	min = pos - halfSize;
@@ -16,34 +19,16 @@ void AABB::RenderFill(SDL_Color color) {
 	Vec2 min, max;
 	GetMinMax(min, max);
 
-	Engine::Instance()->AddRenderOp(std::move(
-		std::dynamic_pointer_cast<RenderOp>(std::make_shared<RenderOpRectFill>(
-			(SDL_FRect){min.x, min.y, halfSize.x * 2, halfSize.y * 2},
-			color))));
+	Engine::Instance()->AddRenderOp(RenderOp::RectFill(
+		(SDL_FRect){min.x, min.y, halfSize.x * 2, halfSize.y * 2}, color));
 }
 
 void AABB::RenderOutline(SDL_Color color) {
 	Vec2 min, max;
 	GetMinMax(min, max);
 
-	// Offset outline by 1px
-	max -= 1.0;
-
-	std::shared_ptr<SDL_FPoint[]> points(new SDL_FPoint[5]);
-	points[0].x = min.x;
-	points[0].y = min.y;
-	points[1].x = max.x;
-	points[1].y = min.y;
-	points[2].x = max.x;
-	points[2].y = max.y;
-	points[3].x = min.x;
-	points[3].y = max.y;
-	points[4].x = min.x;
-	points[4].y = min.y;
-
-	Engine::Instance()->AddRenderOp(
-		std::move(std::dynamic_pointer_cast<RenderOp>(
-			std::make_shared<RenderOpRectOutline>(points, color))));
+	Engine::Instance()->AddRenderOp(RenderOp::RectOutline(
+		(SDL_FRect){min.x, min.y, halfSize.x * 2, halfSize.y * 2}, color));
 }
 
 Hit AABB::RayIntersect(Vec2 position, Vec2 mag) {
@@ -132,6 +117,11 @@ Vec2 AABB::GetPenetration(AABB* minkowski) {
 }
 
 void Physics::Update() {
+	PROFILE_SCOPE("Physics::Update");
+	ALLOC_SCOPE("Physics::Update");
+	PerfCountersScope perfScope(Engine::Instance()->GetPerfCounters().get(),
+								PerfCounters::PhysicsSection);
+
 	for (size_t i = 0; i < Engine::Instance()->GetAllRigidBodies().size();
 		 ++i) {
 		auto& rigidBody = Engine::Instance()->GetAllRigidBodies()[i];
@@ -159,9 +149,35 @@ Hit Physics::SweepStaticBodies(std::shared_ptr<RigidBody> rigidBody,
 						  rigidBody->collisionMask, staticBody->collisionLayer);
 	}
 
+	SweepTileMap(&result, rigidBody, scaledVel);
+
 	return result;
 }
 
+void Physics::SweepTileMap(Hit* result, std::shared_ptr<RigidBody> rigidBody,
+						   Vec2 scaledVel) {
+	auto tileMap = Engine::Instance()->GetTileMap();
+	if (tileMap == nullptr) return;
+
+	AABB subject = rigidBody->GetEntity()->aabb;
+
+	// Only check the cells that could be reached by the sweep (which can also
+	// hit up to a full step backwards)
+	Vec2 min, max;
+	subject.GetMinMax(min, max);
+	min -= scaledVel.Abs();
+	max += scaledVel.Abs();
+
+	int minX, minY, maxX, maxY;
+	if (!tileMap->GetCellRange(min, max, minX, minY, maxX, maxY)) return;
+
+	tileMap->VisitColliders(
+		minX, minY, maxX, maxY, [&](const AABB& aabb, uint8_t collisionLayer) {
+			UpdateSweepResult(result, nullptr, subject, aabb, scaledVel,
+							  rigidBody->collisionMask, collisionLayer);
+		});
+}
+
 Hit Physics::SweepRigidBodies(std::shared_ptr<RigidBody> rigidBody, Vec2 vel,
 							  double velScale) {
 	Hit result = {0};
@@ -197,6 +213,9 @@ void Physics::UpdateSweepResult(Hit* result, std::shared_ptr<Body> hitBody,
 	Hit hit = sumAABB.RayIntersect(subject.pos, vel);
 	if (!hit.isHit) return;
 
+	hit.hitBody = hitBody;
+	hit.collisionLayer = obstacleCollisionLayer;
+
 	if (hit.time < result->time) {
 		*result = hit;
 	} else if (hit.time == result->time) {
@@ -207,8 +226,6 @@ void Physics::UpdateSweepResult(Hit* result, std::shared_ptr<Body> hitBody,
 			*result = hit;
 		}
 	}
-
-	result->hitBody = hitBody;
 }
 
 void Physics::SweepResponse(std::shared_ptr<RigidBody> rigidBody, Vec2 vel,
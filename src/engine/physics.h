@@ -22,7 +22,9 @@ struct Hit {
 	float time;
 	Vec2 pos;
 	Vec2 normal;
+	// Null when hitting a tile from the tile map
 	std::shared_ptr<Body> hitBody;
+	uint8_t collisionLayer;
 };
 
 struct AABB {
@@ -50,6 +52,9 @@ class Physics {
 	static Hit SweepStaticBodies(std::shared_ptr<RigidBody> rigidBody,
 								 Vec2 scaledVel);
 
+	static void SweepTileMap(Hit* result, std::shared_ptr<RigidBody> rigidBody,
+							 Vec2 scaledVel);
+
 	static Hit SweepRigidBodies(std::shared_ptr<RigidBody> rigidBody, Vec2 vel,
 								double velScale);
 
@@ -0,0 +1,212 @@
+#include "engine/profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "config.h"
+
+namespace Profiler {
+
+struct Event {
+	const char* name;
+	const char* category;
+	uint64_t start;
+	uint64_t end;
+	uint32_t frame;
+};
+
+struct ThreadBuffer {
+	int id;
+	std::string name;
+
+	std::unique_ptr<Event[]> events;
+	// Total number of events ever recorded, the ring only keeps the last ones
+	uint64_t count;
+
+	inline uint64_t GetFirst() const {
+		return count > Config::ProfilerEventsPerThread
+				   ? count - Config::ProfilerEventsPerThread
+				   : 0;
+	}
+
+	inline const Event& Get(uint64_t i) const {
+		return events[i % Config::ProfilerEventsPerThread];
+	}
+};
+
+// Buffers are never freed, so the thread local pointers stay valid
+static std::mutex s_BuffersMutex;
+static std::vector<std::unique_ptr<ThreadBuffer>> s_Buffers;
+
+static thread_local ThreadBuffer* t_Buffer = nullptr;
+
+static std::atomic<uint32_t> s_Frame(0);
+
+static const uint64_t s_StartTime = Now();
+
+static ThreadBuffer* GetThreadBuffer() {
+	if (t_Buffer != nullptr) return t_Buffer;
+
+	auto buffer = std::make_unique<ThreadBuffer>();
+	buffer->events =
+		std::make_unique<Event[]>(Config::ProfilerEventsPerThread);
+	buffer->count = 0;
+
+	std::lock_guard<std::mutex> lock(s_BuffersMutex);
+	buffer->id = s_Buffers.size();
+	buffer->name = "Thread " + std::to_string(buffer->id);
+	t_Buffer = buffer.get();
+	s_Buffers.push_back(std::move(buffer));
+
+	return t_Buffer;
+}
+
+uint64_t Now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			   std::chrono::steady_clock::now().time_since_epoch())
+		.count();
+}
+
+void Record(const char* name, const char* category, uint64_t start,
+			uint64_t end) {
+	ThreadBuffer* buffer = GetThreadBuffer();
+
+	Event& event = buffer->events[buffer->count %
+								  Config::ProfilerEventsPerThread];
+	event.name = name;
+	event.category = category;
+	event.start = start;
+	event.end = end;
+	event.frame = s_Frame.load(std::memory_order_relaxed);
+
+	buffer->count++;
+}
+
+void BeginFrame() { s_Frame.fetch_add(1, std::memory_order_relaxed); }
+
+void SetThreadName(const char* name) { GetThreadBuffer()->name = name; }
+
+bool WriteChromeTrace(const std::string& path) {
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open()) {
+		std::cerr << "Couldn't open profiler trace file: '" << path << "'!"
+				  << std::endl;
+		return false;
+	}
+
+	// Timestamps are in microseconds
+	auto toMicros = [](uint64_t time) {
+		return (time - std::min(time, s_StartTime)) / 1000.0;
+	};
+
+	file << "{\"traceEvents\":[";
+
+	bool first = true;
+	for (const auto& buffer : s_Buffers) {
+		file << (first ? "" : ",") << "\n{\"name\":\"thread_name\","
+			 << "\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->id
+			 << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+		first = false;
+
+		for (uint64_t i = buffer->GetFirst(); i < buffer->count; ++i) {
+			const Event& event = buffer->Get(i);
+
+			file << ",\n{\"name\":\"" << event.name << "\",\"cat\":\""
+				 << (event.category ? event.category : "Scope")
+				 << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->id
+				 << ",\"ts\":" << toMicros(event.start)
+				 << ",\"dur\":" << (event.end - event.start) / 1000.0
+				 << ",\"args\":{\"frame\":" << event.frame << "}}";
+		}
+	}
+
+	file << "\n]}\n";
+
+	return true;
+}
+
+static std::string GetColumnName(const Event& event) {
+	if (event.category == nullptr) return event.name;
+	return std::string(event.category) + "/" + event.name;
+}
+
+bool WriteFrameCsv(const std::string& path) {
+	std::ofstream file(path, std::ios::trunc);
+	if (!file.is_open()) {
+		std::cerr << "Couldn't open profiler CSV file: '" << path << "'!"
+				  << std::endl;
+		return false;
+	}
+
+	// Only include frames which haven't been partially overwritten in any of
+	// the ring buffers
+	uint32_t firstFrame = 0;
+	uint32_t lastFrame = 0;
+	bool hasEvents = false;
+	for (const auto& buffer : s_Buffers) {
+		if (buffer->count == 0) continue;
+
+		uint64_t first = buffer->GetFirst();
+		if (first > 0) {
+			firstFrame = std::max(firstFrame, buffer->Get(first).frame + 1);
+		}
+		lastFrame = std::max(lastFrame, buffer->Get(buffer->count - 1).frame);
+		hasEvents = true;
+	}
+
+	// Columns are each unique scope, in a stable (sorted) order
+	std::map<std::string, size_t> columns;
+	for (const auto& buffer : s_Buffers) {
+		for (uint64_t i = buffer->GetFirst(); i < buffer->count; ++i) {
+			columns.emplace(GetColumnName(buffer->Get(i)), 0);
+		}
+	}
+
+	size_t columnIndex = 0;
+	file << "frame";
+	for (auto& column : columns) {
+		column.second = columnIndex++;
+		file << "," << column.first;
+	}
+	file << "\n";
+
+	if (!hasEvents || firstFrame > lastFrame) return true;
+
+	// Total milliseconds per frame + column
+	size_t frameCount = lastFrame - firstFrame + 1;
+	std::vector<double> totals(frameCount * columns.size(), 0.0);
+
+	for (const auto& buffer : s_Buffers) {
+		for (uint64_t i = buffer->GetFirst(); i < buffer->count; ++i) {
+			const Event& event = buffer->Get(i);
+			if (event.frame < firstFrame) continue;
+
+			totals[(event.frame - firstFrame) * columns.size() +
+				   columns[GetColumnName(event)]] +=
+				(event.end - event.start) / 1000000.0;
+		}
+	}
+
+	for (size_t frame = 0; frame < frameCount; ++frame) {
+		file << firstFrame + frame;
+		for (size_t column = 0; column < columns.size(); ++column) {
+			file << "," << totals[frame * columns.size() + column];
+		}
+		file << "\n";
+	}
+
+	return true;
+}
+
+}  // namespace Profiler
+
+#endif
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// A low overhead scoped profiler, compiled out entirely unless ENABLE_PROFILER
+// is defined (eg. 'cmake -DENABLE_PROFILER=ON'). Each thread records its
+// scopes into its own fixed size ring buffer, so recording never locks and
+// only the most recent events are kept. Once the threads have stopped, these
+// can be exported as a Chrome trace (for chrome://tracing or Perfetto) or as a
+// CSV with the total time spent in each scope per frame.
+//
+// Names + categories aren't copied, so must outlive the profiler (eg. string
+// literals or the names of component types).
+
+#ifdef ENABLE_PROFILER
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#define PROFILE_SCOPE(name) \
+	ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name, nullptr)
+#define PROFILE_SCOPE_CATEGORY(name, category) \
+	ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name, category)
+
+#define PROFILE_FRAME() Profiler::BeginFrame()
+#define PROFILE_THREAD(name) Profiler::SetThreadName(name)
+
+namespace Profiler {
+// Nanoseconds since an arbitrary point
+uint64_t Now();
+
+void Record(const char* name, const char* category, uint64_t start,
+			uint64_t end);
+
+// Starts a new frame, which events recorded afterwards (on any thread) belong
+// to. Called by the simulation thread at the start of every tick.
+void BeginFrame();
+void SetThreadName(const char* name);
+
+// Must only be called once all the recording threads have stopped
+bool WriteChromeTrace(const std::string& path);
+bool WriteFrameCsv(const std::string& path);
+}  // namespace Profiler
+
+class ProfileScope {
+   public:
+	inline ProfileScope(const char* name, const char* category)
+		: m_Name(name), m_Category(category), m_Start(Profiler::Now()) {}
+
+	inline ~ProfileScope() {
+		Profiler::Record(m_Name, m_Category, m_Start, Profiler::Now());
+	}
+
+   private:
+	const char* m_Name;
+	const char* m_Category;
+	uint64_t m_Start;
+};
+
+#else
+
+#define PROFILE_SCOPE(name)
+#define PROFILE_SCOPE_CATEGORY(name, category)
+
+#define PROFILE_FRAME()
+#define PROFILE_THREAD(name)
+
+#endif
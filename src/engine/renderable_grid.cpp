@@ -0,0 +1,133 @@
+#include "engine/renderable_grid.h"
+
+#include <cmath>
+
+#include "engine/components/renderables.h"
+#include "engine/engine.h"
+#include "engine/entity.h"
+#include "utils.h"
+
+RenderableGrid::RenderableGrid(float cellSize) : m_CellSize(cellSize) {}
+
+void RenderableGrid::Insert(Renderable* renderable) {
+	ASSERT(renderable->m_GridIndex == -1);
+
+	int entryIndex = m_Entries.size();
+	renderable->m_GridIndex = entryIndex;
+	m_Entries.push_back({renderable, 0, -1});
+
+	AddToCell(entryIndex, GetCellKey(renderable->GetEntity()->visualAABB));
+}
+
+void RenderableGrid::Remove(Renderable* renderable) {
+	int entryIndex = renderable->m_GridIndex;
+	ASSERT(entryIndex >= 0 && entryIndex < (int)m_Entries.size());
+
+	RemoveFromCell(entryIndex);
+
+	// Swap with the last entry to keep entries contiguous
+	int lastIndex = m_Entries.size() - 1;
+	if (entryIndex != lastIndex) {
+		Entry& last = m_Entries[lastIndex];
+		GetCell(last.cellKey)[last.cellIndex] = entryIndex;
+		last.renderable->m_GridIndex = entryIndex;
+		m_Entries[entryIndex] = last;
+	}
+
+	m_Entries.pop_back();
+	renderable->m_GridIndex = -1;
+}
+
+void RenderableGrid::Update() {
+	for (size_t i = 0; i < m_Entries.size(); ++i) {
+		Entry& entry = m_Entries[i];
+
+		int64_t key = GetCellKey(entry.renderable->GetEntity()->visualAABB);
+		if (key == entry.cellKey) continue;
+
+		RemoveFromCell(i);
+		AddToCell(i, key);
+	}
+}
+
+FrameVector<Renderable*> RenderableGrid::Query(const AABB& aabb) {
+	FrameVector<Renderable*> results(
+		Engine::Instance()->GetFrameAllocator<Renderable*>());
+	// Reserve the worst case, as growing would leave the old storage unused
+	// within the arena
+	results.reserve(m_Entries.size());
+
+	AABB queryAABB = aabb;
+	auto testEntry = [this, &results, &queryAABB](int entryIndex) {
+		Renderable* renderable = m_Entries[entryIndex].renderable;
+		AABB* entryAABB = &renderable->GetEntity()->visualAABB;
+
+		if (AABB::CheckIntersection(entryAABB, &queryAABB)) {
+			results.push_back(renderable);
+		}
+	};
+
+	Vec2 min, max;
+	aabb.GetMinMax(min, max);
+
+	// Include neighbouring cells, as renderables are only binned by center
+	int minX = (int)floorf(min.x / m_CellSize) - 1;
+	int minY = (int)floorf(min.y / m_CellSize) - 1;
+	int maxX = (int)floorf(max.x / m_CellSize) + 1;
+	int maxY = (int)floorf(max.y / m_CellSize) + 1;
+
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			auto it = m_Cells.find(GetCellKey(x, y));
+			if (it == m_Cells.end()) continue;
+
+			for (int entryIndex : it->second) {
+				testEntry(entryIndex);
+			}
+		}
+	}
+
+	for (int entryIndex : m_Oversized) {
+		testEntry(entryIndex);
+	}
+
+	return results;
+}
+
+int64_t RenderableGrid::GetCellKey(int x, int y) const {
+	return (int64_t)x << 32 | (uint32_t)y;
+}
+
+int64_t RenderableGrid::GetCellKey(const AABB& aabb) const {
+	if (aabb.halfSize.x > m_CellSize || aabb.halfSize.y > m_CellSize) {
+		return m_OversizedKey;
+	}
+
+	return GetCellKey((int)floorf(aabb.pos.x / m_CellSize),
+					  (int)floorf(aabb.pos.y / m_CellSize));
+}
+
+std::vector<int>& RenderableGrid::GetCell(int64_t key) {
+	return key == m_OversizedKey ? m_Oversized : m_Cells[key];
+}
+
+void RenderableGrid::AddToCell(int entryIndex, int64_t key) {
+	std::vector<int>& cell = GetCell(key);
+
+	m_Entries[entryIndex].cellKey = key;
+	m_Entries[entryIndex].cellIndex = cell.size();
+	cell.push_back(entryIndex);
+}
+
+void RenderableGrid::RemoveFromCell(int entryIndex) {
+	Entry& entry = m_Entries[entryIndex];
+	std::vector<int>& cell = GetCell(entry.cellKey);
+
+	// Swap with the last in the cell, keeping the cell contiguous
+	int movedEntryIndex = cell.back();
+	cell[entry.cellIndex] = movedEntryIndex;
+	m_Entries[movedEntryIndex].cellIndex = entry.cellIndex;
+	cell.pop_back();
+
+	entry.cellIndex = -1;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "engine/physics.h"
+#include "engine/types/frame_allocator.h"
+
+// A loose uniform grid of the (non-static) renderables, so only the ones near
+// the camera need to be visited each frame. Each renderable is binned by the
+// cell containing its center, so queries check one extra ring of cells to
+// catch renderables overlapping in from neighbours. Renderables bigger than a
+// cell are kept separately and always tested.
+
+class Renderable;
+
+class RenderableGrid {
+   public:
+	RenderableGrid(float cellSize);
+
+	void Insert(Renderable* renderable);
+	void Remove(Renderable* renderable);
+
+	// Re-bins any renderables that have moved cells since the last update
+	void Update();
+
+	// Gets all the renderables overlapping 'aabb', allocated from the engine's
+	// frame arena
+	FrameVector<Renderable*> Query(const AABB& aabb);
+
+   private:
+	struct Entry {
+		Renderable* renderable;
+		int64_t cellKey;
+		// Index within the cell (or oversized list)
+		int cellIndex;
+	};
+
+	static constexpr int64_t m_OversizedKey = INT64_MIN;
+
+	int64_t GetCellKey(int x, int y) const;
+	int64_t GetCellKey(const AABB& aabb) const;
+
+	std::vector<int>& GetCell(int64_t key);
+
+	void AddToCell(int entryIndex, int64_t key);
+	void RemoveFromCell(int entryIndex);
+
+   private:
+	float m_CellSize;
+
+	std::vector<Entry> m_Entries;
+
+	std::unordered_map<int64_t, std::vector<int>> m_Cells;
+	std::vector<int> m_Oversized;
+};
@@ -1,25 +1,154 @@
 #include "engine/renderop.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "engine/engine.h"
+#include "engine/static_layer.h"
+#include "engine/types/radix_sort.h"
+#include "utils.h"
+
+void RenderOp::Execute(SDL_Renderer* renderer) const {
+	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+
+	switch (type) {
+		case RenderOpType::RectFill:
+			SDL_RenderFillRectF(renderer, &rect);
+			break;
+
+		case RenderOpType::RectOutline: {
+			// Offset outline by 1px
+			float maxX = rect.x + rect.w - 1;
+			float maxY = rect.y + rect.h - 1;
+
+			SDL_FPoint points[5] = {{rect.x, rect.y},
+									{maxX, rect.y},
+									{maxX, maxY},
+									{rect.x, maxY},
+									{rect.x, rect.y}};
+			SDL_RenderDrawLinesF(renderer, points, 5);
+			break;
+		}
+
+		case RenderOpType::StaticLayer:
+			Engine::Instance()->GetStaticLayer()->Draw(renderer, rect);
+			break;
+	}
+}
+
+size_t RenderBatch::Build(const RenderOp* ops, const uint64_t* sortedKeys,
+						  size_t count, LinearArena& arena,
+						  RenderBatch** outBatches) {
+	*outBatches = nullptr;
+	if (count == 0) return 0;
+
+	size_t batchCount = 1;
+	for (size_t i = 1; i < count; ++i) {
+		if (!RenderOp::HasSameState(sortedKeys[i - 1], sortedKeys[i])) {
+			batchCount++;
+		}
+	}
+
+	RenderBatch* batches = arena.Allocate<RenderBatch>(batchCount);
+	SDL_FRect* rects = arena.Allocate<SDL_FRect>(count);
+
+	size_t batchIndex = 0;
+	for (size_t i = 0; i < count; ++i) {
+		const RenderOp& op = ops[sortedKeys[i] & RenderOp::IndexMask];
+
+		if (i == 0) {
+			batches[0] = {op.type, op.color, rects, 0};
+		} else if (!RenderOp::HasSameState(sortedKeys[i - 1], sortedKeys[i])) {
+			batches[++batchIndex] = {op.type, op.color, rects + i, 0};
+		}
+
+		rects[i] = op.rect;
+		batches[batchIndex].count++;
+	}
+
+	*outBatches = batches;
+	return batchCount;
+}
 
-RenderOp::RenderOp(int order) : m_Order(order) {}
-RenderOp::~RenderOp() {}
+int RenderBatch::Execute(SDL_Renderer* renderer) const {
+	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
 
-RenderOpRectFill::RenderOpRectFill(SDL_FRect rect, SDL_Color color, int order)
-	: RenderOp(order), m_Rect(rect), m_Color(color) {}
+	switch (type) {
+		case RenderOpType::RectFill:
+			SDL_RenderFillRectsF(renderer, rects, count);
+			return 1;
 
-void RenderOpRectFill::Execute() const {
-	SDL_SetRenderDrawColor(Engine::Instance()->renderer, m_Color.r, m_Color.g,
-						   m_Color.b, m_Color.a);
-	SDL_RenderFillRectF(Engine::Instance()->renderer, &m_Rect);
+		case RenderOpType::RectOutline:
+			// Matches 'RenderOp::Execute()', as SDL also insets the right and
+			// bottom edges of rect outlines by 1px
+			SDL_RenderDrawRectsF(renderer, rects, count);
+			return 1;
+
+		case RenderOpType::StaticLayer: {
+			int drawCallCount = 0;
+			for (int i = 0; i < count; ++i) {
+				drawCallCount += Engine::Instance()->GetStaticLayer()->Draw(
+					renderer, rects[i]);
+			}
+			return drawCallCount;
+		}
+	}
+
+	return 0;
+}
+
+RenderBuffer::RenderBuffer()
+	: m_Ops(nullptr),
+	  m_Keys(nullptr),
+	  m_Count(0),
+	  m_Capacity(0),
+	  m_LastCount(0),
+	  m_InputTime(0) {}
+
+void RenderBuffer::Add(const RenderOp& renderOp) {
+	ASSERT(renderOp.order >= RenderOp::MinOrder &&
+		   renderOp.order <= RenderOp::MaxOrder);
+	ASSERT(m_Count <= RenderOp::IndexMask);
+
+	if (m_Count == m_Capacity) Grow();
+
+	m_Ops[m_Count] = renderOp;
+	m_Keys[m_Count] = RenderOp::MakeSortKey(renderOp, m_Count);
+	m_Count++;
 }
 
-RenderOpRectOutline::RenderOpRectOutline(std::shared_ptr<SDL_FPoint[]> points,
-										 SDL_Color color, int order)
-	: RenderOp(order), m_Points(points), m_Color(color) {}
+void RenderBuffer::Clear() {
+	m_LastCount = m_Count;
 
-void RenderOpRectOutline::Execute() const {
-	SDL_SetRenderDrawColor(Engine::Instance()->renderer, m_Color.r, m_Color.g,
-						   m_Color.b, m_Color.a);
-	SDL_RenderDrawLinesF(Engine::Instance()->renderer, m_Points.get(), 5);
-}
\ No newline at end of file
+	m_Arena.Reset();
+	m_Ops = nullptr;
+	m_Keys = nullptr;
+	m_Count = 0;
+	m_Capacity = 0;
+	m_InputTime = 0;
+}
+
+void RenderBuffer::Sort(LinearArena& scratchArena) {
+	if (RadixSort::IsSorted(m_Keys, m_Count)) return;
+
+	// The submission index bits don't need sorting, as the keys start out in
+	// submission order and the sort is stable
+	uint64_t* scratch = scratchArena.Allocate<uint64_t>(m_Count);
+	RadixSort::Sort(m_Keys, scratch, m_Count, RenderOp::IndexBits);
+}
+
+void RenderBuffer::Grow() {
+	size_t capacity =
+		m_Capacity == 0 ? std::max(m_LastCount, m_MinCapacity) : m_Capacity * 2;
+
+	RenderOp* ops = m_Arena.Allocate<RenderOp>(capacity);
+	uint64_t* keys = m_Arena.Allocate<uint64_t>(capacity);
+	if (m_Count > 0) {
+		std::memcpy(ops, m_Ops, m_Count * sizeof(RenderOp));
+		std::memcpy(keys, m_Keys, m_Count * sizeof(uint64_t));
+	}
+
+	m_Ops = ops;
+	m_Keys = keys;
+	m_Capacity = capacity;
+}
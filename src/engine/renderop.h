@@ -2,49 +2,139 @@
 
 #include <SDL.h>
 
-#include <memory>
+#include <cstdint>
+#include <type_traits>
 
-// Small containers of data + functions on how to render the data. This is
-// intended for threaded rendering as this requires much less memory than
-// storing a copied instance of the world simply for just rendering (as there is
-// a lot of state data that is NOT used for rendering)
+#include "engine/color.h"
+#include "engine/types/linear_arena.h"
 
-class Engine;
+// Small containers of data on how to render the data. This is intended for
+// threaded rendering as this requires much less memory than storing a copied
+// instance of the world simply for just rendering (as there is a lot of state
+// data that is NOT used for rendering).
 
-class RenderOp {
-   protected:
-	RenderOp(int order = 0);
+// Render ops are plain data tagged by type (rather than a class hierarchy) so
+// they can be written straight into a per-frame arena and executed via a switch
+// without any heap allocations or virtual calls.
 
-   public:
-	virtual ~RenderOp();
+// Each op submitted to a render buffer gets a packed 64-bit sort key, which
+// determines the draw order:
+//   [63..56] order (biased, so must fit in an int8_t)
+//   [55..54] type
+//   [53..22] color
+//   [21.. 0] submission index (also used to look the op back up)
+
+enum class RenderOpType : uint8_t {
+	RectFill,
+	RectOutline,
+	// Draws the cached static layer, with 'rect' being the world space view
+	StaticLayer,
+};
 
-	virtual void Execute() const = 0;
+struct RenderOp {
+	RenderOpType type;
+	int order;
+	SDL_Color color;
+	SDL_FRect rect;
 
-	inline int GetOrder() const { return m_Order; }
+	static inline RenderOp RectFill(SDL_FRect rect, SDL_Color color,
+									int order = 0) {
+		return {RenderOpType::RectFill, order, color, rect};
+	}
 
-   private:
-	int m_Order;
+	static inline RenderOp RectOutline(SDL_FRect rect, SDL_Color color,
+									   int order = 0) {
+		return {RenderOpType::RectOutline, order, color, rect};
+	}
+
+	// Always drawn beneath everything else
+	static inline RenderOp StaticLayer(SDL_FRect view) {
+		return {RenderOpType::StaticLayer, MinOrder, Color::White, view};
+	}
+
+	void Execute(SDL_Renderer* renderer) const;
+
+	static constexpr int MinOrder = INT8_MIN;
+	static constexpr int MaxOrder = INT8_MAX;
+
+	static constexpr int IndexBits = 22;
+	static constexpr uint64_t IndexMask = (1ull << IndexBits) - 1;
+
+	static inline uint64_t MakeSortKey(const RenderOp& op, uint32_t index) {
+		uint64_t order = (uint64_t)(op.order - MinOrder);
+		return order << 56 | (uint64_t)op.type << 54 |
+			   (uint64_t)Color::ToUint32(op.color) << IndexBits |
+			   (index & IndexMask);
+	}
+
+	// Whether two keys share the same type and color, ignoring order and index
+	static inline bool HasSameState(uint64_t keyA, uint64_t keyB) {
+		constexpr uint64_t stateMask = ((1ull << 34) - 1) << IndexBits;
+		return (keyA & stateMask) == (keyB & stateMask);
+	}
 };
 
-class RenderOpRectFill : public RenderOp {
-   public:
-	RenderOpRectFill(SDL_FRect rect, SDL_Color color, int order = 0);
+static_assert(std::is_trivially_copyable<RenderOp>::value,
+			  "RenderOp must stay POD to live in the render buffer arena");
 
-	void Execute() const override;
+// A run of consecutive (sorted) render ops sharing the same type and color, so
+// they can be submitted with a single SDL call instead of one per op
 
-   private:
-	SDL_FRect m_Rect;
-	SDL_Color m_Color;
+struct RenderBatch {
+	RenderOpType type;
+	SDL_Color color;
+	const SDL_FRect* rects;
+	int count;
+
+	// Returns the number of batches written to 'outBatches', with both the
+	// batches and their rects allocated from 'arena'
+	static size_t Build(const RenderOp* ops, const uint64_t* sortedKeys,
+						size_t count, LinearArena& arena,
+						RenderBatch** outBatches);
+
+	// Returns the number of draw calls made
+	int Execute(SDL_Renderer* renderer) const;
 };
 
-class RenderOpRectOutline : public RenderOp {
+// A single frame worth of render ops, stored contiguously in a linear arena
+// that is reset (not freed) once the buffer is reused
+
+class RenderBuffer {
    public:
-	RenderOpRectOutline(std::shared_ptr<SDL_FPoint[]> points, SDL_Color color,
-						int order = 0);
+	RenderBuffer();
+
+	void Add(const RenderOp& renderOp);
+	void Clear();
+
+	// Sorts the keys into draw order, skipped if they're already in order.
+	// This is stable + deterministic as the submission index is part of the
+	// key.
+	void Sort(LinearArena& scratchArena);
+
+	inline const RenderOp* GetOps() const { return m_Ops; }
+	inline const uint64_t* GetKeys() const { return m_Keys; }
+	inline size_t size() const { return m_Count; }
+
+	// When the earliest input this frame acted on was polled (see
+	// 'FrameStats::Now()'), 0 if it didn't act on any new input
+	inline uint64_t GetInputTime() const { return m_InputTime; }
+	inline void SetInputTime(uint64_t time) { m_InputTime = time; }
 
-	void Execute() const override;
+   private:
+	void Grow();
 
    private:
-	std::shared_ptr<SDL_FPoint[]> m_Points;
-	SDL_Color m_Color;
-};
\ No newline at end of file
+	static constexpr size_t m_MinCapacity = 256;
+
+	LinearArena m_Arena;
+
+	RenderOp* m_Ops;
+	uint64_t* m_Keys;
+	size_t m_Count;
+	size_t m_Capacity;
+
+	// Used to pre-size the next frame, avoiding regrowing every frame
+	size_t m_LastCount;
+
+	uint64_t m_InputTime;
+};
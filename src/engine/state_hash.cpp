@@ -0,0 +1,166 @@
+#include "engine/state_hash.h"
+
+#include <iostream>
+
+#include "engine/engine.h"
+#include "engine/entity.h"
+#include "engine/types/entity_collection.h"
+
+static constexpr char Magic[4] = {'T', 'D', 'S', 'H'};
+static constexpr uint32_t Version = 1;
+
+static void WriteUint(std::ofstream& file, uint64_t value, int bytes) {
+	char buffer[8];
+	for (int i = 0; i < bytes; ++i) {
+		buffer[i] = (char)((value >> (i * 8)) & 0xFF);
+	}
+	file.write(buffer, bytes);
+}
+
+static bool ReadUint(std::ifstream& file, uint64_t& value, int bytes) {
+	unsigned char buffer[8];
+	if (!file.read((char*)buffer, bytes)) return false;
+
+	value = 0;
+	for (int i = 0; i < bytes; ++i) {
+		value |= (uint64_t)buffer[i] << (i * 8);
+	}
+
+	return true;
+}
+
+struct TickHashes {
+	uint64_t tick;
+	uint64_t worldHash;
+	std::vector<uint64_t> entityHashes;
+};
+
+static bool ReadTick(std::ifstream& file, TickHashes& tick) {
+	uint64_t entityCount;
+	if (!ReadUint(file, tick.tick, 8) || !ReadUint(file, tick.worldHash, 8) ||
+		!ReadUint(file, entityCount, 4)) {
+		return false;
+	}
+
+	tick.entityHashes.resize(entityCount);
+	for (auto& entityHash : tick.entityHashes) {
+		if (!ReadUint(file, entityHash, 8)) return false;
+	}
+
+	return true;
+}
+
+static bool OpenForReading(std::ifstream& file, const std::string& path) {
+	file.open(path, std::ios::binary);
+	if (!file.is_open()) {
+		std::cerr << "Couldn't open state hash file: '" << path << "'!"
+				  << std::endl;
+		return false;
+	}
+
+	char magic[sizeof(Magic)];
+	uint64_t version;
+	if (!file.read(magic, sizeof(magic)) ||
+		std::memcmp(magic, Magic, sizeof(Magic)) != 0 ||
+		!ReadUint(file, version, 4) || version != Version) {
+		std::cerr << "Invalid state hash file: '" << path << "'!" << std::endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool StateHashRecorder::Open(const std::string& path) {
+	m_File.open(path, std::ios::binary | std::ios::trunc);
+	if (!m_File.is_open()) {
+		std::cerr << "Couldn't open state hash file: '" << path << "'!"
+				  << std::endl;
+		return false;
+	}
+
+	m_File.write(Magic, sizeof(Magic));
+	WriteUint(m_File, Version, 4);
+
+	return true;
+}
+
+void StateHashRecorder::RecordTick(uint64_t tick) {
+	m_EntityHashes.clear();
+
+	StateHash worldHash;
+	for (const auto& collection : Engine::Instance()->GetEntityCollections()) {
+		for (const auto& entity : collection->GetEntities()) {
+			StateHash entityHash;
+			entity->HashState(entityHash);
+
+			worldHash.Add(entityHash.Get());
+			m_EntityHashes.push_back(entityHash.Get());
+		}
+	}
+
+	WriteUint(m_File, tick, 8);
+	WriteUint(m_File, worldHash.Get(), 8);
+	WriteUint(m_File, m_EntityHashes.size(), 4);
+	for (uint64_t entityHash : m_EntityHashes) {
+		WriteUint(m_File, entityHash, 8);
+	}
+}
+
+int StateHashRecorder::Diff(const std::string& pathA,
+							const std::string& pathB) {
+	std::ifstream fileA, fileB;
+	if (!OpenForReading(fileA, pathA) || !OpenForReading(fileB, pathB)) {
+		return 2;
+	}
+
+	TickHashes tickA, tickB;
+	uint64_t tickCount = 0;
+	while (true) {
+		bool hasA = ReadTick(fileA, tickA);
+		bool hasB = ReadTick(fileB, tickB);
+
+		if (!hasA || !hasB) {
+			if (hasA == hasB) break;
+
+			std::cout << "Diverged after " << tickCount << " ticks: '"
+					  << (hasA ? pathB : pathA) << "' ended early"
+					  << std::endl;
+			return 1;
+		}
+
+		if (tickA.tick != tickB.tick) {
+			std::cout << "Diverged after " << tickCount
+					  << " ticks: tick numbers differ (" << tickA.tick
+					  << " vs " << tickB.tick << ")" << std::endl;
+			return 1;
+		}
+
+		if (tickA.worldHash != tickB.worldHash) {
+			std::cout << "Diverged at tick " << tickA.tick;
+
+			size_t entityCount = std::min(tickA.entityHashes.size(),
+										  tickB.entityHashes.size());
+			size_t entity = 0;
+			while (entity < entityCount &&
+				   tickA.entityHashes[entity] == tickB.entityHashes[entity]) {
+				++entity;
+			}
+
+			if (entity < entityCount) {
+				std::cout << ": entity " << entity << " differs";
+			} else {
+				std::cout << ": entity counts differ ("
+						  << tickA.entityHashes.size() << " vs "
+						  << tickB.entityHashes.size() << ")";
+			}
+			std::cout << std::endl;
+
+			return 1;
+		}
+
+		++tickCount;
+	}
+
+	std::cout << "Identical over " << tickCount << " ticks" << std::endl;
+	return 0;
+}
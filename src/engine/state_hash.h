@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "engine/types/vec2.h"
+
+// Hashing of the simulation's state after every fixed tick, so changes to
+// physics, iteration order etc. can be checked to not have changed the
+// simulation (eg. by replaying a recording before and after and diffing the
+// hash streams).
+//
+// Each entity is hashed (in collection order) from its active flag, position
+// and its components' state (see 'Component::HashState'), and the world hash
+// combines those. The entity hashes are kept so a diff can point at the first
+// entity which diverged.
+//
+// Layout (little endian):
+//   Header: "TDSH", u32 version
+//   Ticks:  u64 tick, u64 world hash, u32 entity count, u64 entity hashes
+
+class StateHash {
+   public:
+	StateHash() : m_Hash(m_Seed) {}
+
+	inline void Add(uint64_t value) {
+		// Multiply-xorshift mix per word, cheap enough to run every tick
+		m_Hash = (m_Hash ^ value) * m_Multiplier;
+		m_Hash ^= m_Hash >> 32;
+	}
+
+	inline void Add(bool value) { Add((uint64_t)value); }
+	inline void Add(int value) { Add((uint64_t)(uint32_t)value); }
+
+	inline void Add(float value) {
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		Add((uint64_t)bits);
+	}
+
+	inline void Add(double value) {
+		uint64_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		Add(bits);
+	}
+
+	inline void Add(Vec2 value) {
+		uint32_t x, y;
+		std::memcpy(&x, &value.x, sizeof(x));
+		std::memcpy(&y, &value.y, sizeof(y));
+		Add(((uint64_t)x << 32) | y);
+	}
+
+	inline uint64_t Get() const { return m_Hash; }
+
+   private:
+	static constexpr uint64_t m_Seed = 0xcbf29ce484222325ull;
+	static constexpr uint64_t m_Multiplier = 0x9e3779b97f4a7c15ull;
+
+	uint64_t m_Hash;
+};
+
+class StateHashRecorder {
+   public:
+	bool Open(const std::string& path);
+
+	// Hashes all the entities registered with the engine
+	void RecordTick(uint64_t tick);
+
+	// Compares two hash streams, printing the first divergent tick + entity.
+	// Returns 0 if they match, 1 if they diverge and 2 if either is invalid.
+	static int Diff(const std::string& pathA, const std::string& pathB);
+
+   private:
+	std::ofstream m_File;
+	std::vector<uint64_t> m_EntityHashes;
+};
@@ -0,0 +1,294 @@
+#include "engine/static_layer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "config.h"
+#include "engine/components/renderables.h"
+#include "engine/types/vec2.h"
+#include "utils.h"
+
+StaticLayer::StaticLayer()
+	: m_IsDirty(false),
+	  m_RedrawAll(false),
+	  m_ChunksMinX(0),
+	  m_ChunksMinY(0),
+	  m_ChunksX(0),
+	  m_ChunksY(0),
+	  m_IsSupported(false),
+	  m_IsSupportChecked(false) {}
+
+void StaticLayer::Add(Renderable* renderable) {
+	m_Renderables.push_back(renderable);
+	Invalidate();
+}
+
+void StaticLayer::Remove(Renderable* renderable) {
+	auto it = std::find(m_Renderables.begin(), m_Renderables.end(), renderable);
+
+	ASSERT(it != m_Renderables.end());
+	m_Renderables.erase(it);
+	Invalidate();
+}
+
+void StaticLayer::Invalidate(const SDL_FRect& region) {
+	m_IsDirty = true;
+	m_DirtyRegions.push_back(region);
+}
+
+void StaticLayer::Update() {
+	for (auto* renderable : m_Renderables) {
+		if (renderable->HasStaticStateChanged()) Invalidate();
+	}
+
+	if (!m_IsDirty) return;
+	m_IsDirty = false;
+
+	auto snapshot = std::make_shared<Snapshot>();
+	for (auto* renderable : m_Renderables) {
+		renderable->RenderStatic(snapshot->ops);
+	}
+
+	// Ops are rasterized in the order they're stored
+	std::stable_sort(snapshot->ops.begin(), snapshot->ops.end(),
+					 [](const RenderOp& l, const RenderOp& r) {
+						 return l.order < r.order;
+					 });
+
+	if (!snapshot->ops.empty()) {
+		Vec2 min(INFINITY), max(-INFINITY);
+		for (const auto& op : snapshot->ops) {
+			min.x = std::min(min.x, op.rect.x);
+			min.y = std::min(min.y, op.rect.y);
+			max.x = std::max(max.x, op.rect.x + op.rect.w);
+			max.y = std::max(max.y, op.rect.y + op.rect.h);
+		}
+
+		constexpr float chunkSize = Config::StaticLayerChunkSize;
+		min = Vec2(floorf(min.x / chunkSize), floorf(min.y / chunkSize)) *
+			  chunkSize;
+		snapshot->bounds = {min.x, min.y, max.x - min.x, max.y - min.y};
+	} else {
+		snapshot->bounds = {0, 0, 0, 0};
+	}
+
+	snapshot->redrawAll = m_RedrawAll;
+	snapshot->dirtyRegions = std::move(m_DirtyRegions);
+	m_RedrawAll = false;
+	m_DirtyRegions.clear();
+
+	std::lock_guard<std::mutex> lock(m_PendingMutex);
+
+	// The main thread hasn't picked up the last snapshot yet, so whatever
+	// changed in that one still needs redrawing too
+	if (m_PendingSnapshot != nullptr) {
+		snapshot->redrawAll |= m_PendingSnapshot->redrawAll;
+		snapshot->dirtyRegions.insert(snapshot->dirtyRegions.end(),
+									  m_PendingSnapshot->dirtyRegions.begin(),
+									  m_PendingSnapshot->dirtyRegions.end());
+	}
+
+	m_PendingSnapshot = std::move(snapshot);
+}
+
+int StaticLayer::Draw(SDL_Renderer* renderer, const SDL_FRect& view) {
+	// Note: the snapshot can be picked up a frame before the render buffer it
+	// was captured alongside, which is fine given how rarely it changes
+	{
+		std::lock_guard<std::mutex> lock(m_PendingMutex);
+		if (m_PendingSnapshot != nullptr) {
+			m_Snapshot = std::move(m_PendingSnapshot);
+			m_PendingSnapshot = nullptr;
+			RebuildChunks();
+		}
+	}
+
+	if (m_Snapshot == nullptr) return 0;
+
+	CheckSupport(renderer);
+	if (!m_IsSupported) return DrawOps(renderer, view);
+
+	const SDL_FRect& bounds = m_Snapshot->bounds;
+	constexpr float chunkSize = Config::StaticLayerChunkSize;
+
+	int minX = std::max((int)floorf((view.x - bounds.x) / chunkSize), 0);
+	int minY = std::max((int)floorf((view.y - bounds.y) / chunkSize), 0);
+	int maxX = std::min(
+		(int)floorf((view.x + view.w - bounds.x) / chunkSize), m_ChunksX - 1);
+	int maxY = std::min(
+		(int)floorf((view.y + view.h - bounds.y) / chunkSize), m_ChunksY - 1);
+
+	int drawCallCount = 0;
+	for (int y = minY; y <= maxY; ++y) {
+		for (int x = minX; x <= maxX; ++x) {
+			Chunk& chunk = m_Chunks[y * m_ChunksX + x];
+			if (chunk.opIndices.empty()) continue;
+
+			float chunkX = bounds.x + x * chunkSize;
+			float chunkY = bounds.y + y * chunkSize;
+
+			if (chunk.texture == nullptr &&
+				!RasterizeChunk(renderer, chunk, chunkX, chunkY)) {
+				// Couldn't create the texture, so give up on caching
+				m_IsSupported = false;
+				ReleaseTextures();
+				return DrawOps(renderer, view);
+			}
+
+			SDL_FRect dst = {chunkX - view.x, chunkY - view.y, chunkSize,
+							 chunkSize};
+			SDL_RenderCopyF(renderer, chunk.texture, NULL, &dst);
+			drawCallCount++;
+		}
+	}
+
+	return drawCallCount;
+}
+
+void StaticLayer::ReleaseTextures() {
+	for (auto& chunk : m_Chunks) {
+		if (chunk.texture != nullptr) SDL_DestroyTexture(chunk.texture);
+		chunk.texture = nullptr;
+	}
+}
+
+void StaticLayer::CheckSupport(SDL_Renderer* renderer) {
+	if (m_IsSupportChecked) return;
+	m_IsSupportChecked = true;
+
+	// Ops are rasterized into the (initially transparent) chunks with
+	// premultiplied alpha, then composited as premultiplied, giving the same
+	// result as if they were drawn directly
+	m_RasterizeBlendMode = SDL_ComposeCustomBlendMode(
+		SDL_BLENDFACTOR_SRC_ALPHA, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+		SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE,
+		SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+	m_CompositeBlendMode = SDL_ComposeCustomBlendMode(
+		SDL_BLENDFACTOR_ONE, SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,
+		SDL_BLENDOPERATION_ADD, SDL_BLENDFACTOR_ONE,
+		SDL_BLENDFACTOR_ONE_MINUS_SRC_ALPHA, SDL_BLENDOPERATION_ADD);
+
+	m_IsSupported =
+		SDL_RenderTargetSupported(renderer) &&
+		SDL_SetRenderDrawBlendMode(renderer, m_RasterizeBlendMode) == 0;
+
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+}
+
+void StaticLayer::RebuildChunks() {
+	std::vector<Chunk> oldChunks = std::move(m_Chunks);
+	int oldMinX = m_ChunksMinX;
+	int oldMinY = m_ChunksMinY;
+	int oldChunksX = m_ChunksX;
+	int oldChunksY = m_ChunksY;
+
+	const SDL_FRect& bounds = m_Snapshot->bounds;
+	constexpr float chunkSize = Config::StaticLayerChunkSize;
+
+	m_ChunksMinX = (int)roundf(bounds.x / chunkSize);
+	m_ChunksMinY = (int)roundf(bounds.y / chunkSize);
+	m_ChunksX = (int)ceilf(bounds.w / chunkSize);
+	m_ChunksY = (int)ceilf(bounds.h / chunkSize);
+	m_Chunks.assign(m_ChunksX * m_ChunksY, {nullptr, {}});
+
+	// Move over the textures of chunks which are still in the bounds, and
+	// don't overlap anything that changed (inclusively, matching how the ops
+	// are bucketed below)
+	if (!m_Snapshot->redrawAll) {
+		for (int y = 0; y < m_ChunksY; ++y) {
+			for (int x = 0; x < m_ChunksX; ++x) {
+				int oldX = m_ChunksMinX + x - oldMinX;
+				int oldY = m_ChunksMinY + y - oldMinY;
+				if (oldX < 0 || oldY < 0 || oldX >= oldChunksX ||
+					oldY >= oldChunksY) {
+					continue;
+				}
+
+				float chunkX = bounds.x + x * chunkSize;
+				float chunkY = bounds.y + y * chunkSize;
+				bool isDirty = false;
+				for (const SDL_FRect& region : m_Snapshot->dirtyRegions) {
+					if (region.x <= chunkX + chunkSize &&
+						region.x + region.w >= chunkX &&
+						region.y <= chunkY + chunkSize &&
+						region.y + region.h >= chunkY) {
+						isDirty = true;
+						break;
+					}
+				}
+				if (isDirty) continue;
+
+				Chunk& oldChunk = oldChunks[oldY * oldChunksX + oldX];
+				m_Chunks[y * m_ChunksX + x].texture = oldChunk.texture;
+				oldChunk.texture = nullptr;
+			}
+		}
+	}
+
+	for (auto& chunk : oldChunks) {
+		if (chunk.texture != nullptr) SDL_DestroyTexture(chunk.texture);
+	}
+
+	// Bucket ops into every chunk they overlap
+	for (size_t i = 0; i < m_Snapshot->ops.size(); ++i) {
+		const SDL_FRect& rect = m_Snapshot->ops[i].rect;
+
+		int minX = (int)((rect.x - bounds.x) / chunkSize);
+		int minY = (int)((rect.y - bounds.y) / chunkSize);
+		int maxX = std::min((int)((rect.x + rect.w - bounds.x) / chunkSize),
+							m_ChunksX - 1);
+		int maxY = std::min((int)((rect.y + rect.h - bounds.y) / chunkSize),
+							m_ChunksY - 1);
+
+		for (int y = minY; y <= maxY; ++y) {
+			for (int x = minX; x <= maxX; ++x) {
+				m_Chunks[y * m_ChunksX + x].opIndices.push_back(i);
+			}
+		}
+	}
+}
+
+bool StaticLayer::RasterizeChunk(SDL_Renderer* renderer, Chunk& chunk, float x,
+								 float y) {
+	chunk.texture = SDL_CreateTexture(
+		renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+		Config::StaticLayerChunkSize, Config::StaticLayerChunkSize);
+	if (chunk.texture == nullptr) return false;
+
+	SDL_SetTextureBlendMode(chunk.texture, m_CompositeBlendMode);
+
+	SDL_SetRenderTarget(renderer, chunk.texture);
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_NONE);
+	SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+	SDL_RenderClear(renderer);
+
+	SDL_SetRenderDrawBlendMode(renderer, m_RasterizeBlendMode);
+	for (uint32_t index : chunk.opIndices) {
+		RenderOp op = m_Snapshot->ops[index];
+		op.rect.x -= x;
+		op.rect.y -= y;
+		op.Execute(renderer);
+	}
+
+	SDL_SetRenderTarget(renderer, NULL);
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+
+	return true;
+}
+
+int StaticLayer::DrawOps(SDL_Renderer* renderer, const SDL_FRect& view) const {
+	int drawCallCount = 0;
+	for (RenderOp op : m_Snapshot->ops) {
+		if (op.rect.x > view.x + view.w || op.rect.x + op.rect.w < view.x ||
+			op.rect.y > view.y + view.h || op.rect.y + op.rect.h < view.y) {
+			continue;
+		}
+
+		op.rect.x -= view.x;
+		op.rect.y -= view.y;
+		op.Execute(renderer);
+		drawCallCount++;
+	}
+
+	return drawCallCount;
+}
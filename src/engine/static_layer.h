@@ -0,0 +1,99 @@
+#pragma once
+
+#include <SDL.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "engine/renderop.h"
+
+// Renderables on static entities (eg. level geometry) never change appearance,
+// so rather than culling + submitting them every frame they're captured once
+// into world space render ops. The main thread then lazily rasterizes those
+// into chunked textures, only blitting the chunks visible to the camera each
+// frame. The layer is recaptured whenever a static renderable is added,
+// removed or changes. Renderables which only change part of what they capture
+// (eg. a tile map streaming in chunks) can invalidate just that region, so the
+// chunks elsewhere keep their textures rather than all being redrawn.
+
+class Renderable;
+
+class StaticLayer {
+   public:
+	StaticLayer();
+
+	// Simulation thread
+	void Add(Renderable* renderable);
+	void Remove(Renderable* renderable);
+
+	inline void Invalidate() {
+		m_IsDirty = true;
+		m_RedrawAll = true;
+	}
+	// Only the chunks overlapping the world space region are redrawn
+	void Invalidate(const SDL_FRect& region);
+	inline bool IsEmpty() const { return m_Renderables.empty(); }
+
+	// Recaptures the static renderables if any have changed
+	void Update();
+
+	// Main thread, returns the number of draw calls made (a copy per visible
+	// chunk, or an op each if the chunks aren't supported)
+	int Draw(SDL_Renderer* renderer, const SDL_FRect& view);
+	void ReleaseTextures();
+
+   private:
+	struct Snapshot {
+		std::vector<RenderOp> ops;
+
+		// World space bounds of all of the ops, with the min aligned to the
+		// chunks so they stay in the same place as the bounds change
+		SDL_FRect bounds;
+
+		// What changed since the previous snapshot
+		bool redrawAll;
+		std::vector<SDL_FRect> dirtyRegions;
+	};
+
+	struct Chunk {
+		SDL_Texture* texture;
+		std::vector<uint32_t> opIndices;
+	};
+
+	void CheckSupport(SDL_Renderer* renderer);
+	// Keeps the textures of chunks which haven't changed
+	void RebuildChunks();
+	bool RasterizeChunk(SDL_Renderer* renderer, Chunk& chunk, float x, float y);
+	int DrawOps(SDL_Renderer* renderer, const SDL_FRect& view) const;
+
+   private:
+	// Simulation thread
+	std::vector<Renderable*> m_Renderables;
+	bool m_IsDirty;
+	bool m_RedrawAll;
+	std::vector<SDL_FRect> m_DirtyRegions;
+
+	// Handed from the simulation thread to the main thread, this only happens
+	// when the layer changes, so it's fine to lock
+	std::mutex m_PendingMutex;
+	std::shared_ptr<const Snapshot> m_PendingSnapshot;
+
+	// Main thread
+	std::shared_ptr<const Snapshot> m_Snapshot;
+	std::vector<Chunk> m_Chunks;
+	// In chunks, from the world origin
+	int m_ChunksMinX;
+	int m_ChunksMinY;
+	int m_ChunksX;
+	int m_ChunksY;
+
+	// Whether the renderer supports render targets + the premultiplied
+	// blending needed to composite the chunks, otherwise the captured ops are
+	// drawn directly
+	bool m_IsSupported;
+	bool m_IsSupportChecked;
+
+	SDL_BlendMode m_RasterizeBlendMode;
+	SDL_BlendMode m_CompositeBlendMode;
+};
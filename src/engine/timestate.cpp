@@ -11,7 +11,7 @@
 // https://medium.com/@tglaiel/how-to-make-your-game-run-at-60fps-24c61210fe75
 
 TimeState::TimeState(uint64_t startPerfCounter, uint64_t perfFreq,
-					 double fixedStep)
+					 double fixedStep, int maxFixedTicks)
 	: m_PerfCounter(0),
 	  m_FixedPerfCounter(0),
 	  m_PerfAccumulator(0),
@@ -21,7 +21,11 @@ TimeState::TimeState(uint64_t startPerfCounter, uint64_t perfFreq,
 	  m_DeltaTime(0.0),
 	  m_FixedTime(0.0),
 	  m_FixedStep(fixedStep),
-	  m_FixedStepProgress(0.0) {}
+	  m_FixedStepProgress(0.0),
+	  m_FixedTicks(0),
+	  m_MaxFixedTicks(maxFixedTicks),
+	  m_DroppedTicks(0),
+	  m_TotalDroppedTicks(0) {}
 
 int TimeState::Update(uint64_t perfCounter) {
 	perfCounter -= m_StartPerfCounter;
@@ -36,6 +40,11 @@ int TimeState::Update(uint64_t perfCounter) {
 		m_PerfAccumulator -= fixedStepAsPerfCounter;
 	}
 
+	// Shed the time owed beyond the cap, it's still treated as having passed
+	// (keeping the interpolation in step) but never simulated
+	m_DroppedTicks = std::max(m_FixedTicks - m_MaxFixedTicks, 0);
+	m_TotalDroppedTicks += m_DroppedTicks;
+
 	m_FixedStepProgress = std::clamp(
 		((perfCounter - m_FixedPerfCounter) % fixedStepAsPerfCounter) /
 			(double)fixedStepAsPerfCounter,
@@ -43,6 +52,7 @@ int TimeState::Update(uint64_t perfCounter) {
 
 	m_PerfCounter = perfCounter;
 	m_FixedPerfCounter += m_FixedTicks * fixedStepAsPerfCounter;
+	m_FixedTicks -= m_DroppedTicks;
 
 	double delta = deltaCounter / (double)m_PerfFreq;
 
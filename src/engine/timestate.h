@@ -5,14 +5,24 @@
 // Handles time within the gameloop, schedules how many fixed updates occur in a
 // single variable update frame and delta time for interpolating between frames
 // easily.
+//
+// At most 'maxFixedTicks' are scheduled per frame, so after a stall the fixed
+// updates don't run back-to-back making the next frame late too (and so on).
+// Any more time owed is shed instead, slowing down the simulation for a frame
+// rather than spiralling.
 
 class TimeState {
    public:
-	TimeState(uint64_t startPerfCounter, uint64_t perfFreq, double fixedStep);
+	TimeState(uint64_t startPerfCounter, uint64_t perfFreq, double fixedStep,
+			  int maxFixedTicks);
 
 	int Update(uint64_t perfCounter);
 
 	inline double GetTime() const { return m_Time; }
+	// Converts a performance counter into the same time as 'GetTime()'
+	inline double GetTimeAt(uint64_t perfCounter) const {
+		return (int64_t)(perfCounter - m_StartPerfCounter) / (double)m_PerfFreq;
+	}
 	inline double GetDeltaTime() const { return m_DeltaTime; }
 
 	inline double GetFixedTime() const { return m_FixedTime; }
@@ -21,6 +31,10 @@ class TimeState {
 
 	inline bool FixedUpdateThisFrame() const { return m_FixedTicks > 0; }
 
+	// Ticks shed this frame + in total due to the cap
+	inline int GetDroppedTicks() const { return m_DroppedTicks; }
+	inline uint64_t GetTotalDroppedTicks() const { return m_TotalDroppedTicks; }
+
    private:
 	uint64_t m_PerfCounter;
 	uint64_t m_FixedPerfCounter;
@@ -37,4 +51,8 @@ class TimeState {
 	double m_FixedStepProgress;
 
 	int m_FixedTicks;
+	int m_MaxFixedTicks;
+
+	int m_DroppedTicks;
+	uint64_t m_TotalDroppedTicks;
 };
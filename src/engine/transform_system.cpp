@@ -0,0 +1,118 @@
+#include "engine/transform_system.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "engine/entity.h"
+#include "engine/mathutils.h"
+#include "utils.h"
+
+void TransformSystem::Register(Entity* entity) {
+	ASSERT(entity->m_TransformIndex == -1);
+
+	entity->m_TransformIndex = m_Entities.size();
+	m_Entities.push_back(entity);
+
+	// Start from rest so newly activated entities don't lerp in from wherever
+	// they were last active
+	Vec2 pos = entity->aabb.pos;
+	m_PrevX.push_back(pos.x);
+	m_PrevY.push_back(pos.y);
+	m_CurX.push_back(pos.x);
+	m_CurY.push_back(pos.y);
+	m_VisualX.push_back(pos.x);
+	m_VisualY.push_back(pos.y);
+
+	entity->visualAABB.pos = pos;
+}
+
+void TransformSystem::Unregister(Entity* entity) {
+	int index = entity->m_TransformIndex;
+	ASSERT(index >= 0 && index < (int)m_Entities.size());
+
+	// Swap remove
+	int last = m_Entities.size() - 1;
+	if (index != last) {
+		m_Entities[index] = m_Entities[last];
+		m_Entities[index]->m_TransformIndex = index;
+
+		m_PrevX[index] = m_PrevX[last];
+		m_PrevY[index] = m_PrevY[last];
+		m_CurX[index] = m_CurX[last];
+		m_CurY[index] = m_CurY[last];
+		m_VisualX[index] = m_VisualX[last];
+		m_VisualY[index] = m_VisualY[last];
+	}
+
+	m_Entities.pop_back();
+	m_PrevX.pop_back();
+	m_PrevY.pop_back();
+	m_CurX.pop_back();
+	m_CurY.pop_back();
+	m_VisualX.pop_back();
+	m_VisualY.pop_back();
+
+	entity->m_TransformIndex = -1;
+}
+
+void TransformSystem::Snapshot() {
+	size_t count = m_Entities.size();
+	Entity* const* entities = m_Entities.data();
+	float* prevX = m_PrevX.data();
+	float* prevY = m_PrevY.data();
+
+	for (size_t i = 0; i < count; ++i) {
+		const Vec2& pos = entities[i]->aabb.pos;
+		prevX[i] = pos.x;
+		prevY[i] = pos.y;
+	}
+}
+
+void TransformSystem::Interpolate(float t) {
+	size_t count = m_Entities.size();
+	Entity* const* entities = m_Entities.data();
+
+	// Positions are still owned by the entities, so gather the current ones
+	// before the lerp and scatter the results back after it
+	float* curX = m_CurX.data();
+	float* curY = m_CurY.data();
+	for (size_t i = 0; i < count; ++i) {
+		const Vec2& pos = entities[i]->aabb.pos;
+		curX[i] = pos.x;
+		curY[i] = pos.y;
+	}
+
+	const float* prevX = m_PrevX.data();
+	const float* prevY = m_PrevY.data();
+	float* visualX = m_VisualX.data();
+	float* visualY = m_VisualY.data();
+
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	__m128 tWide = _mm_set1_ps(t);
+	for (; i + 4 <= count; i += 4) {
+		__m128 aX = _mm_loadu_ps(prevX + i);
+		__m128 aY = _mm_loadu_ps(prevY + i);
+		__m128 bX = _mm_loadu_ps(curX + i);
+		__m128 bY = _mm_loadu_ps(curY + i);
+
+		_mm_storeu_ps(visualX + i,
+					  _mm_add_ps(aX, _mm_mul_ps(_mm_sub_ps(bX, aX), tWide)));
+		_mm_storeu_ps(visualY + i,
+					  _mm_add_ps(aY, _mm_mul_ps(_mm_sub_ps(bY, aY), tWide)));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		visualX[i] = MathUtils::Lerp(prevX[i], curX[i], t);
+		visualY[i] = MathUtils::Lerp(prevY[i], curY[i], t);
+	}
+
+	for (i = 0; i < count; ++i) {
+		Vec2& visualPos = entities[i]->visualAABB.pos;
+		visualPos.x = visualX[i];
+		visualPos.y = visualY[i];
+	}
+}
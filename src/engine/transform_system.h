@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Keeps the transforms of all active, non-static entities in contiguous
+// (structure of arrays) buffers, so snapshotting the last positions and
+// interpolating the visual positions are each a single tight pass rather than
+// visiting every entity through the collections. Static entities never move,
+// so their visual position always matches their physics position and they're
+// never registered here.
+
+class Entity;
+
+class TransformSystem {
+   public:
+	void Register(Entity* entity);
+	void Unregister(Entity* entity);
+
+	// Stores every registered entity's current position as its last position,
+	// called before the fixed updates of each frame
+	void Snapshot();
+
+	// Lerps the visual positions between the last and current positions
+	void Interpolate(float t);
+
+	inline size_t size() const { return m_Entities.size(); }
+
+   private:
+	std::vector<Entity*> m_Entities;
+
+	std::vector<float> m_PrevX;
+	std::vector<float> m_PrevY;
+	std::vector<float> m_CurX;
+	std::vector<float> m_CurY;
+	std::vector<float> m_VisualX;
+	std::vector<float> m_VisualY;
+};
@@ -2,12 +2,17 @@
 
 #include <iostream>
 
+#include "engine/alloc_tracker.h"
 #include "engine/engine.h"
 #include "engine/entity.h"
+#include "engine/profiler.h"
 
-EntityCollection::EntityCollection() {}
+EntityCollection::EntityCollection() : m_ClearQueued(false), m_Id(-1) {}
 
 void EntityCollection::ProcessAddQueue() {
+	PROFILE_SCOPE("EntityCollection::ProcessAddQueue");
+	ALLOC_SCOPE("EntityCollection::ProcessAddQueue");
+
 	if (m_AddQueue.size() > 0) {
 		for (auto&& entity : m_AddQueue) {
 			AddEntity(std::move(entity));
@@ -18,25 +23,27 @@ void EntityCollection::ProcessAddQueue() {
 }
 
 void EntityCollection::ProcessRemoveQueue() {
-	if (m_RemoveQueue.size() > 0) {
-		if (m_Entities.size() > m_RemoveQueue.size() && !m_ClearQueued) {
-			// Traverse in reverse to not invalidate proceeding indexes from the
-			// queue by offsetting the indexes of queued for deletion entities
-			for (int i = m_AddQueue.size() - 1; i >= 0; i--) {
-				auto& pair = m_RemoveQueue[i];
-				RemoveEntity(pair.first, pair.second);
-			}
-		} else {
-			m_Entities.clear();
-			m_ClearQueued = false;
-		}
+	PROFILE_SCOPE("EntityCollection::ProcessRemoveQueue");
+	ALLOC_SCOPE("EntityCollection::ProcessRemoveQueue");
 
-		m_RemoveQueue.clear();
+	if (m_ClearQueued) {
+		// Removes any queued entities too
+		RemoveAllEntities();
+		m_ClearQueued = false;
+	} else {
+		// Traverse in reverse to not invalidate proceeding indexes from the
+		// queue by offsetting the indexes of queued for deletion entities
+		for (int i = m_RemoveQueue.size() - 1; i >= 0; i--) {
+			auto& pair = m_RemoveQueue[i];
+			RemoveEntity(pair.first, pair.second);
+		}
 	}
+
+	m_RemoveQueue.clear();
 }
 
 void EntityCollection::Add(std::shared_ptr<Entity>&& entity) {
-	entity->m_Collection = shared_from_this();
+	entity->m_Collection = this;
 	if (Engine::Instance()->CanAddOrRemoveEntities()) {
 		// Can safely add the entity instantly
 		AddEntity(std::move(entity));
@@ -69,7 +76,7 @@ void EntityCollection::RemoveAt(int index) {
 void EntityCollection::Clear() {
 	if (Engine::Instance()->CanAddOrRemoveEntities()) {
 		// Can safely remove all the entities instantly
-		m_Entities.clear();
+		RemoveAllEntities();
 	} else {
 		// Must queue clear for later
 		m_ClearQueued = true;
@@ -179,6 +186,10 @@ void EntityCollection::SetEntityActive(std::shared_ptr<Entity> entity,
 
 void EntityCollection::RegisterEntityActive(std::shared_ptr<Entity> entity) {
 	m_ActiveEntities.push_back(entity);
+
+	if (!entity->IsStatic()) {
+		Engine::Instance()->GetTransformSystem()->Register(entity.get());
+	}
 }
 
 void EntityCollection::RegisterEntityInactive(std::shared_ptr<Entity> entity) {
@@ -193,6 +204,10 @@ void EntityCollection::UnregisterEntityActive(std::shared_ptr<Entity> entity) {
 	int index = std::distance(m_ActiveEntities.begin(), it);
 
 	m_ActiveEntities.erase(m_ActiveEntities.begin() + index);
+
+	if (!entity->IsStatic()) {
+		Engine::Instance()->GetTransformSystem()->Unregister(entity.get());
+	}
 }
 
 void EntityCollection::UnregisterEntityInactive(
@@ -208,7 +223,7 @@ void EntityCollection::UnregisterEntityInactive(
 
 void EntityCollection::RemoveInternal(std::shared_ptr<Entity> entity,
 									  int index) {
-	entity->m_Collection = NULL;
+	entity->m_Collection = nullptr;
 	if (Engine::Instance()->CanAddOrRemoveEntities()) {
 		// Can safely remove the entity instantly
 		RemoveEntity(entity, index);
@@ -262,6 +277,14 @@ void EntityCollection::RemoveEntity(std::shared_ptr<Entity> entity, int index) {
 	m_Entities.erase(m_Entities.begin() + index);
 }
 
+void EntityCollection::RemoveAllEntities() {
+	// Remove from the back, so nothing needs shifting down
+	for (int i = m_Entities.size() - 1; i >= 0; i--) {
+		m_Entities[i]->m_Collection = nullptr;
+		RemoveEntity(m_Entities[i], i);
+	}
+}
+
 struct EntityCollection::MakeSharedEnabler : public EntityCollection {
 	MakeSharedEnabler() : EntityCollection() {}
 };
\ No newline at end of file
@@ -70,6 +70,8 @@ class EntityCollection : public std::enable_shared_from_this<EntityCollection> {
 
 	void AddEntity(std::shared_ptr<Entity>&& entity);
 	void RemoveEntity(std::shared_ptr<Entity> entity, int index);
+	// Unregisters + cleans up every entity, rather than just dropping them
+	void RemoveAllEntities();
 
    private:
 	std::vector<std::shared_ptr<Entity>> m_Entities;
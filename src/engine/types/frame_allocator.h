@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "engine/types/linear_arena.h"
+
+// An STL compatible allocator handing out memory from a linear arena, so
+// containers of transient data (eg. query results) don't touch the heap.
+// Deallocation is a no-op, the memory is only released when the arena is
+// reset, so containers must not outlive it (see 'Engine::GetFrameArena()').
+
+template <typename T>
+class FrameAllocator {
+   public:
+	typedef T value_type;
+
+	FrameAllocator(LinearArena* arena) : m_Arena(arena) {}
+
+	template <typename U>
+	FrameAllocator(const FrameAllocator<U>& other) : m_Arena(other.m_Arena) {}
+
+	inline T* allocate(size_t count) {
+		return static_cast<T*>(
+			m_Arena->Allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	inline void deallocate(T*, size_t) {}
+
+	template <typename U>
+	inline bool operator==(const FrameAllocator<U>& other) const {
+		return m_Arena == other.m_Arena;
+	}
+
+	template <typename U>
+	inline bool operator!=(const FrameAllocator<U>& other) const {
+		return m_Arena != other.m_Arena;
+	}
+
+   private:
+	template <typename U>
+	friend class FrameAllocator;
+
+	LinearArena* m_Arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, FrameAllocator<T>>;
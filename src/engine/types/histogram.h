@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// A lock-free log-linear histogram (in the style of HdrHistogram), which any
+// number of threads can record into and read from concurrently. Each power of
+// two range is split into linear sub buckets, keeping recorded values within
+// 1/32 (~3%) of their actual value, whilst covering the full range of
+// 'uint64_t' in a fixed amount of memory.
+
+class Histogram {
+   public:
+	Histogram() { Reset(); }
+
+	inline void Record(uint64_t value) {
+		m_Buckets[GetBucketIndex(value)].fetch_add(1,
+												   std::memory_order_relaxed);
+		m_Count.fetch_add(1, std::memory_order_relaxed);
+
+		uint64_t max = m_Max.load(std::memory_order_relaxed);
+		while (value > max && !m_Max.compare_exchange_weak(
+								  max, value, std::memory_order_relaxed)) {
+		}
+	}
+
+	inline void Reset() {
+		for (auto& bucket : m_Buckets) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+		m_Count.store(0, std::memory_order_relaxed);
+		m_Max.store(0, std::memory_order_relaxed);
+	}
+
+	inline uint64_t GetCount() const {
+		return m_Count.load(std::memory_order_relaxed);
+	}
+	inline uint64_t GetMax() const {
+		return m_Max.load(std::memory_order_relaxed);
+	}
+
+	// Gets the (highest equivalent) value at the given percentile (0-100)
+	uint64_t GetPercentile(double percentile) const {
+		uint64_t count = GetCount();
+		if (count == 0) return 0;
+
+		uint64_t target = (uint64_t)(percentile / 100.0 * count + 0.5);
+		if (target < 1) target = 1;
+
+		uint64_t cumulative = 0;
+		for (size_t i = 0; i < m_BucketCount; ++i) {
+			cumulative += m_Buckets[i].load(std::memory_order_relaxed);
+			if (cumulative >= target) {
+				uint64_t value = GetBucketHighestValue(i);
+				return value < GetMax() ? value : GetMax();
+			}
+		}
+
+		return GetMax();
+	}
+
+   private:
+	static constexpr int m_SubBucketBits = 5;
+	static constexpr uint64_t m_SubBucketCount = 1 << m_SubBucketBits;
+	// Values below the sub bucket count are exact, then each following power
+	// of two gets its own set of sub buckets
+	static constexpr size_t m_BucketCount =
+		(64 - m_SubBucketBits + 1) * m_SubBucketCount;
+
+	static inline size_t GetBucketIndex(uint64_t value) {
+		if (value < m_SubBucketCount) return value;
+
+		int shift = (63 - __builtin_clzll(value)) - m_SubBucketBits;
+		return (shift + 1) * m_SubBucketCount +
+			   ((value >> shift) - m_SubBucketCount);
+	}
+
+	static inline uint64_t GetBucketHighestValue(size_t index) {
+		if (index < m_SubBucketCount) return index;
+
+		int shift = index / m_SubBucketCount - 1;
+		uint64_t top = index % m_SubBucketCount + m_SubBucketCount;
+		return ((top + 1) << shift) - 1;
+	}
+
+	std::atomic<uint64_t> m_Buckets[m_BucketCount];
+	std::atomic<uint64_t> m_Count;
+	std::atomic<uint64_t> m_Max;
+};
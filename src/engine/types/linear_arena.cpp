@@ -0,0 +1,74 @@
+#include "engine/types/linear_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+#include "utils.h"
+
+static inline size_t AlignOffset(const std::byte* base, size_t offset,
+								 size_t alignment) {
+	uintptr_t address = reinterpret_cast<uintptr_t>(base) + offset;
+	uintptr_t aligned = (address + alignment - 1) & ~(alignment - 1);
+	return offset + (aligned - address);
+}
+
+LinearArena::LinearArena(size_t initialCapacity) : m_Offset(0), m_Used(0) {
+	AddBlock(initialCapacity);
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment) {
+	ASSERT((alignment & (alignment - 1)) == 0);
+
+	Block* block = &m_Blocks.back();
+	size_t offset = AlignOffset(block->data.get(), m_Offset, alignment);
+
+	if (offset + size > block->size) {
+		// Out of space, chain on a block big enough for this allocation
+		AddBlock(std::max(block->size * 2, size + alignment));
+
+		block = &m_Blocks.back();
+		offset = AlignOffset(block->data.get(), 0, alignment);
+	}
+
+	m_Used += (offset - m_Offset) + size;
+	m_Offset = offset + size;
+
+	return block->data.get() + offset;
+}
+
+void LinearArena::Reset() {
+#ifndef NDEBUG
+	// Only the current block's offset is known, so the earlier ones are
+	// poisoned whole
+	for (size_t i = 0; i < m_Blocks.size(); ++i) {
+		bool isLast = i + 1 == m_Blocks.size();
+		std::memset(m_Blocks[i].data.get(), (int)m_PoisonByte,
+					isLast ? m_Offset : m_Blocks[i].size);
+	}
+#endif
+
+	if (m_Blocks.size() > 1) {
+		// Merge into a single block that fits everything from this frame
+		size_t capacity = std::max(GetCapacity(), m_Used);
+		m_Blocks.clear();
+		AddBlock(capacity);
+	}
+
+	m_Offset = 0;
+	m_Used = 0;
+}
+
+size_t LinearArena::GetCapacity() const {
+	size_t capacity = 0;
+	for (const auto& block : m_Blocks) {
+		capacity += block.size;
+	}
+
+	return capacity;
+}
+
+void LinearArena::AddBlock(size_t size) {
+	m_Blocks.push_back({std::make_unique<std::byte[]>(size), size});
+	m_Offset = 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// A simple bump allocator, memory is handed out linearly and only ever released
+// all at once via 'Reset()'. If the current block runs out, another block is
+// chained on and on the next reset they're merged into a single block that fits
+// the high-water mark, so after the first few frames no heap allocations occur.
+//
+// In debug builds the released memory is poisoned on reset, so anything still
+// reading it afterwards sees obvious garbage rather than plausible stale data.
+
+class LinearArena {
+   public:
+	LinearArena(size_t initialCapacity = 64 * 1024);
+
+	void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+	// Returns uninitialized storage, so only intended for POD types
+	template <typename T>
+	inline T* Allocate(size_t count = 1) {
+		static_assert(std::is_trivially_copyable<T>::value &&
+						  std::is_trivially_destructible<T>::value,
+					  "LinearArena only supports POD types");
+		return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+	}
+
+	void Reset();
+
+	inline size_t GetUsed() const { return m_Used; }
+	size_t GetCapacity() const;
+
+   private:
+	void AddBlock(size_t size);
+
+	static constexpr std::byte m_PoisonByte{0xCD};
+
+   private:
+	struct Block {
+		std::unique_ptr<std::byte[]> data;
+		size_t size;
+	};
+
+	std::vector<Block> m_Blocks;
+
+	size_t m_Offset;
+	size_t m_Used;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+// Stable LSD radix sort over 64-bit keys, only considering the bits in the
+// range ['firstBit', 64). Digits where every key shares the same value are
+// skipped, which is common for sparse keys (eg. only a couple of render orders
+// being used). 'scratch' must be able to hold 'count' keys.
+
+namespace RadixSort {
+constexpr int DigitBits = 8;
+constexpr size_t DigitCount = 1 << DigitBits;
+constexpr uint64_t DigitMask = DigitCount - 1;
+
+inline bool IsSorted(const uint64_t* keys, size_t count) {
+	for (size_t i = 1; i < count; ++i) {
+		if (keys[i - 1] > keys[i]) return false;
+	}
+
+	return true;
+}
+
+inline void Sort(uint64_t* keys, uint64_t* scratch, size_t count,
+				 int firstBit = 0) {
+	uint64_t* src = keys;
+	uint64_t* dst = scratch;
+
+	for (int shift = firstBit; shift < 64; shift += DigitBits) {
+		size_t offsets[DigitCount] = {0};
+		for (size_t i = 0; i < count; ++i) {
+			offsets[(src[i] >> shift) & DigitMask]++;
+		}
+
+		// All keys share this digit, so this pass wouldn't move anything
+		if (offsets[(src[0] >> shift) & DigitMask] == count) continue;
+
+		size_t total = 0;
+		for (size_t& offset : offsets) {
+			size_t digitCount = offset;
+			offset = total;
+			total += digitCount;
+		}
+
+		for (size_t i = 0; i < count; ++i) {
+			dst[offsets[(src[i] >> shift) & DigitMask]++] = src[i];
+		}
+
+		std::swap(src, dst);
+	}
+
+	if (src != keys) std::memcpy(keys, src, count * sizeof(uint64_t));
+}
+}  // namespace RadixSort
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Lock-free single producer, single consumer ring buffer of a fixed capacity
+// (a power of 2). The producer and consumer each own one index, only reading
+// the other's, so neither ever waits; pushing into a full ring just fails.
+
+template <class T, size_t Capacity>
+class SpscRing {
+	static_assert((Capacity & (Capacity - 1)) == 0,
+				  "SpscRing capacity must be a power of 2");
+
+   public:
+	SpscRing() : m_Head(0), m_Tail(0) {}
+
+	// Producer side, returns false if full
+	inline bool TryPush(const T& value) {
+		size_t tail = m_Tail.load(std::memory_order_relaxed);
+		if (tail - m_Head.load(std::memory_order_acquire) == Capacity) {
+			return false;
+		}
+
+		m_Items[tail & m_IndexMask] = value;
+		m_Tail.store(tail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side, returns null if empty. The item stays valid until popped.
+	inline const T* Peek() const {
+		size_t head = m_Head.load(std::memory_order_relaxed);
+		if (head == m_Tail.load(std::memory_order_acquire)) return nullptr;
+
+		return &m_Items[head & m_IndexMask];
+	}
+
+	inline void Pop() {
+		m_Head.store(m_Head.load(std::memory_order_relaxed) + 1,
+					 std::memory_order_release);
+	}
+
+   private:
+	static constexpr size_t m_IndexMask = Capacity - 1;
+
+	T m_Items[Capacity];
+
+	// Kept on separate cache lines, as each is written by a different thread
+	alignas(64) std::atomic<size_t> m_Head;
+	alignas(64) std::atomic<size_t> m_Tail;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single producer, single consumer triple buffer. The producer always
+// has a buffer to write into and the consumer always has a buffer to read from,
+// with the third buffer being exchanged between them via a single atomic. This
+// means neither side ever waits on the other, the consumer just picks up the
+// most recently published buffer (skipping any it missed).
+
+template <class T>
+class TripleBuffer {
+   public:
+	TripleBuffer() : m_WriteIndex(0), m_ReadIndex(2), m_Shared(1) {}
+
+	// Producer side
+	inline T& GetWriteBuffer() { return m_Buffers[m_WriteIndex]; }
+
+	inline void Publish() {
+		uint8_t previous = m_Shared.exchange(m_WriteIndex | m_FreshBit,
+											 std::memory_order_acq_rel);
+		m_WriteIndex = previous & m_IndexMask;
+	}
+
+	// Consumer side
+	inline T& GetReadBuffer() { return m_Buffers[m_ReadIndex]; }
+
+	// Returns true if a newly published buffer was picked up
+	inline bool Consume() {
+		if (!HasPending()) return false;
+
+		uint8_t previous =
+			m_Shared.exchange(m_ReadIndex, std::memory_order_acq_rel);
+		m_ReadIndex = previous & m_IndexMask;
+		return true;
+	}
+
+	// Either side
+	inline bool HasPending() const {
+		return m_Shared.load(std::memory_order_acquire) & m_FreshBit;
+	}
+
+   private:
+	static constexpr uint8_t m_IndexMask = 0b011;
+	static constexpr uint8_t m_FreshBit = 0b100;
+
+	T m_Buffers[3];
+
+	uint8_t m_WriteIndex;
+	uint8_t m_ReadIndex;
+	std::atomic<uint8_t> m_Shared;
+};
@@ -142,7 +142,7 @@ struct Vec2 {
 
 	// TODO:
 	inline static Vec2 RandomInCircle(float radius) {
-		return Vec2(radius, 0).RotateByRads(float(rand()) / float((RAND_MAX)) *
-											M_PI * 2);
+		return Vec2(radius, 0).RotateByRads(MathUtils::RandomFloat() * M_PI *
+											2);
 	}
 };
@@ -0,0 +1,19 @@
+#include "engine/world_arena.h"
+
+#include <iostream>
+
+#include "utils.h"
+
+WorldArena::WorldArena(size_t initialCapacity)
+	: m_Arena(initialCapacity), m_LiveCount(0) {}
+
+void WorldArena::Reset() {
+	if (m_LiveCount != 0) {
+		// Something is still holding onto an object, eg. a reference cycle
+		std::cerr << "World arena reset with " << m_LiveCount
+				  << " objects still alive!" << std::endl;
+		ASSERT(m_LiveCount == 0);
+	}
+
+	m_Arena.Reset();
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "engine/types/linear_arena.h"
+
+// Allocates the objects making up a level (entities, components etc.)
+// contiguously from a linear arena, shared pointer control blocks included.
+// When an object is destroyed its memory isn't reused; the whole arena is
+// released at once by 'Reset()' when the level is unloaded. All of the objects
+// must have been destroyed by then, so they can't be referenced from outside
+// the level.
+
+class WorldArena {
+   public:
+	WorldArena(size_t initialCapacity);
+
+	template <typename T, typename... Args>
+	inline std::shared_ptr<T> Create(Args&&... args) {
+		return std::allocate_shared<T>(Allocator<T>(this),
+									   std::forward<Args>(args)...);
+	}
+
+	// Releases everything allocated, asserting nothing is still alive
+	void Reset();
+
+	// Number of allocations that haven't been freed yet
+	inline size_t GetLiveCount() const { return m_LiveCount; }
+	inline size_t GetUsed() const { return m_Arena.GetUsed(); }
+
+   private:
+	template <typename T>
+	class Allocator {
+	   public:
+		typedef T value_type;
+
+		Allocator(WorldArena* world) : m_World(world) {}
+
+		template <typename U>
+		Allocator(const Allocator<U>& other) : m_World(other.m_World) {}
+
+		inline T* allocate(size_t count) {
+			m_World->m_LiveCount++;
+			return static_cast<T*>(
+				m_World->m_Arena.Allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		// Only tracked, the memory is released by 'Reset()'
+		inline void deallocate(T*, size_t) { m_World->m_LiveCount--; }
+
+		template <typename U>
+		inline bool operator==(const Allocator<U>& other) const {
+			return m_World == other.m_World;
+		}
+
+		template <typename U>
+		inline bool operator!=(const Allocator<U>& other) const {
+			return m_World != other.m_World;
+		}
+
+	   private:
+		template <typename U>
+		friend class Allocator;
+
+		WorldArena* m_World;
+	};
+
+   private:
+	LinearArena m_Arena;
+	size_t m_LiveCount;
+};
@@ -2,8 +2,10 @@
 
 #include "game/components/player.h"
 
-const ComponentType GameComponentType::Player = GameComponentType(0);
-const ComponentType GameComponentType::Bullet = GameComponentType(1);
-const ComponentType GameComponentType::Enemy = GameComponentType(2);
-const ComponentType GameComponentType::EnemyManager = GameComponentType(3);
-const ComponentType GameComponentType::GameManager = GameComponentType(4);
\ No newline at end of file
+const ComponentType GameComponentType::Player = GameComponentType(0, "Player");
+const ComponentType GameComponentType::Bullet = GameComponentType(1, "Bullet");
+const ComponentType GameComponentType::Enemy = GameComponentType(2, "Enemy");
+const ComponentType GameComponentType::EnemyManager =
+	GameComponentType(3, "EnemyManager");
+const ComponentType GameComponentType::GameManager =
+	GameComponentType(4, "GameManager");
\ No newline at end of file
@@ -5,8 +5,8 @@
 
 class GameComponentType : public ComponentType {
    private:
-	GameComponentType(int id)
-		: ComponentType(id + Config::GameComponentIdOffset) {
+	GameComponentType(int id, const char* name)
+		: ComponentType(id + Config::GameComponentIdOffset, name) {
 		// Ensure there is separation between engine and game components
 		ASSERT(id + Config::GameComponentIdOffset >=
 			   Config::GameComponentIdOffset);
@@ -24,7 +24,7 @@ void Bullet::FixedUpdate() {
 }
 
 void Bullet::OnHit(Hit* hit) {
-	if (hit->hitBody->collisionLayer & 0b00000010) {
+	if (hit->collisionLayer & 0b00000010) {
 		// Hit obstacle
 		m_Entity->SetActive(false);
 	}
@@ -1,14 +1,17 @@
 #include "game/components/enemy.h"
 
+#include "engine/components/camera.h"
 #include "engine/components/physics.h"
 #include "engine/components/renderables.h"
 #include "engine/engine.h"
 #include "engine/entity.h"
+#include "engine/flow_field.h"
+#include "engine/state_hash.h"
 #include "game/component.h"
 #include "game/components/game_manager.h"
 #include "game/components/player.h"
 
-Enemy::Enemy() : Component(GameComponentType::Enemy) {}
+Enemy::Enemy() : Component(GameComponentType::Enemy), health(0) {}
 
 void Enemy::Setup() {
 	ASSERT(m_Entity->HasComponent(EngineComponentType::RigidBody));
@@ -26,21 +29,39 @@ void Enemy::OnActivate() {
 
 void Enemy::FixedUpdate() {
 	if (player->GetEntity()->IsActive()) {
-		rb->vel =
-			(player->GetEntity()->aabb.pos - m_Entity->aabb.pos).Normalized() *
-			110;
+		// Under load, off-screen enemies only re-steer every few ticks and
+		// keep their last heading in between
+		bool isSteeringTick = Engine::Instance()->GetFixedTickCount() %
+								  Config::OffscreenAITickInterval ==
+							  0;
+		if (!isSteeringTick &&
+			Engine::Instance()->IsDegraded(
+				DegradationLevel::ReducedOffscreenAI) &&
+			!IsOnScreen()) {
+			return;
+		}
+
+		// Follow the flow field around obstacles, only heading straight for
+		// the player when it's close by (or too far away to be covered)
+		Vec2 direction;
+		if (!flowField->GetDirection(m_Entity->aabb.pos, direction)) {
+			direction = (player->GetEntity()->aabb.pos - m_Entity->aabb.pos)
+							.Normalized();
+		}
+
+		rb->vel = direction * 110;
 	} else {
 		rb->vel *= 0.96f;
 	}
 }
 
 void Enemy::OnHit(Hit* hit) {
-	if (hit->hitBody->collisionLayer & 0b00000001) {
+	if (hit->collisionLayer & 0b00000001) {
 		// Hit player
 		player->DealDamage();
 
 		m_Entity->SetActive(false);
-	} else if (hit->hitBody->collisionLayer & 0b00001000) {
+	} else if (hit->collisionLayer & 0b00001000) {
 		// Hit bullet
 		DealDamage();
 
@@ -48,6 +69,13 @@ void Enemy::OnHit(Hit* hit) {
 	}
 }
 
+void Enemy::HashState(StateHash& hash) const { hash.Add(health); }
+
+bool Enemy::IsOnScreen() const {
+	return AABB::CheckIntersection(
+		&m_Entity->aabb, &Engine::Instance()->GetCamera()->GetEntity()->aabb);
+}
+
 void Enemy::DealDamage() {
 	health -= 1;
 
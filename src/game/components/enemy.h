@@ -6,6 +6,7 @@
 class RigidBody;
 class RenderRect;
 class Player;
+class FlowField;
 
 class Enemy : public Component {
    public:
@@ -19,13 +20,19 @@ class Enemy : public Component {
 
 	void OnHit(Hit* hit) override;
 
+	void HashState(StateHash& hash) const override;
+
 	void DealDamage();
 
+   private:
+	bool IsOnScreen() const;
+
    public:
 	std::shared_ptr<RigidBody> rb;
 	std::shared_ptr<RenderRect> renderRect;
 
 	std::shared_ptr<Player> player;
+	std::shared_ptr<FlowField> flowField;
 
 	int health;
 
@@ -5,8 +5,10 @@
 #include "engine/components/camera.h"
 #include "engine/components/physics.h"
 #include "engine/components/renderables.h"
+#include "engine/components/tilemap.h"
 #include "engine/engine.h"
 #include "engine/entity.h"
+#include "engine/flow_field.h"
 #include "engine/types/entity_collection.h"
 #include "game/component.h"
 #include "game/components/enemy.h"
@@ -24,18 +26,25 @@ void EnemyManager::Setup() {
 				 ->GetAllActiveEntities()[playerIndex]
 				 ->GetComponent<Player>(GameComponentType::Player);
 
+	// Only the tiles enemies collide with are in the way
+	flowField = std::make_shared<FlowField>(Config::FlowFieldRadius,
+											m_EnemyCollisionMask);
+
 	enemies = EntityCollection::Create();
 	for (int i = 0; i < m_EnemyPoolSize; ++i) {
 		auto enemy = std::make_shared<Entity>((Vec2){0, 0}, (Vec2){16, 16});
 		enemy->SetActive(false);
 
 		enemy->AddComponent(
-			std::make_shared<RigidBody>(0b00000100, 0b00001111));
+			std::make_shared<RigidBody>(0b00000100, m_EnemyCollisionMask));
 		enemy->AddComponent(std::make_shared<RenderRect>(
 			RenderMode::Both, Color::SetAlpha(Color::Yellow, 127), Color::Red));
 		enemy->AddComponent(std::make_shared<Enemy>());
 
-		enemy->GetComponent<Enemy>(GameComponentType::Enemy)->player = player;
+		auto enemyComponent =
+			enemy->GetComponent<Enemy>(GameComponentType::Enemy);
+		enemyComponent->player = player;
+		enemyComponent->flowField = flowField;
 
 		enemies->Add(std::move(enemy));
 	}
@@ -48,6 +57,10 @@ void EnemyManager::Setup() {
 }
 
 void EnemyManager::PreFixedUpdate() {
+	// Only searches again once the player moves cell
+	flowField->Update(Engine::Instance()->GetTileMap().get(),
+					  player->GetEntity()->aabb.pos);
+
 	m_SpawnTimer += Engine::Instance()->GetTimeState()->GetFixedStep();
 
 	if (enemies->GetInactiveEntities().size() > 0 &&
@@ -63,9 +76,13 @@ void EnemyManager::PreFixedUpdate() {
 			newAABB.pos = camera->GetEntity()->aabb.pos +
 						  Vec2::RandomInCircle(m_SpawnRadius);
 
-			bool isIntersecting = false;
+			auto tileMap = Engine::Instance()->GetTileMap();
+			bool isIntersecting = tileMap != nullptr &&
+								  tileMap->CheckIntersection(&newAABB, 0xFF);
 			for (size_t i = 0;
-				 i < Engine::Instance()->GetAllStaticBodies().size(); ++i) {
+				 !isIntersecting &&
+				 i < Engine::Instance()->GetAllStaticBodies().size();
+				 ++i) {
 				auto& staticBody = Engine::Instance()->GetAllStaticBodies()[i];
 
 				if (AABB::CheckIntersection(&staticBody->GetEntity()->aabb,
@@ -10,6 +10,7 @@ class Player;
 class Camera;
 class Enemy;
 class EntityCollection;
+class FlowField;
 
 class EnemyManager : public Component {
    public:
@@ -25,8 +26,12 @@ class EnemyManager : public Component {
 
 	std::shared_ptr<EntityCollection> enemies;
 
+	// Shared by the enemies to steer around obstacles towards the player
+	std::shared_ptr<FlowField> flowField;
+
    private:
 	const int m_EnemyPoolSize = 50;
+	const uint8_t m_EnemyCollisionMask = 0b00001111;
 
 	const double m_StartSpawnDelay = 1.1;
 	const double m_SpawnDelayDecreasePerSpawn = 0.01;
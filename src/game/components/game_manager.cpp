@@ -7,6 +7,7 @@
 #include "engine/components/renderables.h"
 #include "engine/engine.h"
 #include "engine/entity.h"
+#include "engine/state_hash.h"
 #include "game/component.h"
 #include "utils.h"
 
@@ -38,9 +39,10 @@ void GameManager::Setup() {
 
 void GameManager::Cleanup() {
 	m_GameOver = true;
-	m_AliveTimerThread.join();
 
-	m_AutoQuitThread.detach();
+	// Already joined if the game ended
+	if (m_AliveTimerThread.joinable()) m_AliveTimerThread.join();
+	if (m_AutoQuitThread.joinable()) m_AutoQuitThread.detach();
 }
 
 void GameManager::FixedUpdate() {
@@ -48,6 +50,8 @@ void GameManager::FixedUpdate() {
 		std::clamp(damageFlashRect->fillColor.a - 5, 0, 255);
 }
 
+void GameManager::HashState(StateHash& hash) const { hash.Add(m_Score); }
+
 void GameManager::AddScore() {
 	m_Score++;
 	std::cout << "[Score]: Enemy Defeated!" << std::endl;
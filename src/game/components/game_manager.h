@@ -19,6 +19,9 @@ class GameManager : public Component {
 
 	void FixedUpdate() override;
 
+	// Only the score, the alive duration is timed by a separate thread
+	void HashState(StateHash& hash) const override;
+
 	void AddScore();
 	void GameOver();
 
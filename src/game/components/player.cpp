@@ -11,6 +11,7 @@
 #include "engine/components/renderables.h"
 #include "engine/engine.h"
 #include "engine/entity.h"
+#include "engine/state_hash.h"
 #include "engine/types/entity_collection.h"
 #include "game/component.h"
 #include "game/components/bullet.h"
@@ -63,6 +64,9 @@ void Player::Setup() {
 	}
 
 	health = m_MaxHealth;
+	// Ready to fire straight away, but not invincible
+	m_BulletTimer = m_BulletFireRate;
+	m_InvincibilityTimer = m_InvincibilityDuration;
 
 	std::cout << "[Player]: Health Status: " << health << '/' << m_MaxHealth
 			  << std::endl;
@@ -128,6 +132,14 @@ void Player::Update() {
 	}
 }
 
+void Player::HashState(StateHash& hash) const {
+	hash.Add(health);
+	hash.Add(moveDir);
+	hash.Add(fireDir);
+	hash.Add(m_BulletTimer);
+	hash.Add(m_InvincibilityTimer);
+}
+
 void Player::DealDamage() {
 	if (m_InvincibilityTimer >= m_InvincibilityDuration) {
 		health -= 1;
@@ -21,6 +21,8 @@ class Player : public Component {
 
 	void Update() override;
 
+	void HashState(StateHash& hash) const override;
+
 	void DealDamage();
 
 	bool IsMoving();
@@ -2,6 +2,7 @@
 
 #include <SDL.h>
 
+#include <algorithm>
 #include <fstream>
 #include <iostream>
 #include <memory>
@@ -10,15 +11,20 @@
 #include "engine/components/camera.h"
 #include "engine/components/physics.h"
 #include "engine/components/renderables.h"
+#include "engine/components/tilemap.h"
 #include "engine/engine.h"
 #include "engine/entity.h"
+#include "engine/level_file.h"
 #include "engine/physics.h"
+#include "engine/profiler.h"
 #include "engine/types/entity_collection.h"
 #include "game/components/enemy_manager.h"
 #include "game/components/game_manager.h"
 #include "game/components/player.h"
+#include "utils.h"
 
 std::shared_ptr<EntityCollection> entities;
+std::shared_ptr<EntityCollection> levelEntities;
 
 #define EntityFunctionCall(FuncName)                                          \
 	for (size_t i = 0; i < Engine::Instance()->GetAllActiveEntities().size(); \
@@ -32,6 +38,7 @@ namespace Game {
 
 bool Init() {
 	entities = EntityCollection::Create();
+	levelEntities = EntityCollection::Create();
 
 	auto camera = std::make_shared<Entity>(
 		(Vec2){0, 0},
@@ -42,7 +49,7 @@ bool Init() {
 
 	entities->Add(std::move(camera));
 
-	if (!LoadLevel("levels/level3.txt")) return false;
+	if (!LoadLevel(Engine::Instance()->GetOptions().levelPath)) return false;
 
 	auto gameManagerEntity = std::make_shared<Entity>(Vec2(), Vec2());
 	gameManagerEntity->name = "GameManager";
@@ -68,7 +75,16 @@ bool Init() {
 	return true;
 }
 
-void Cleanup() {}
+void Cleanup() {
+	// Not initialised if the engine didn't run the game
+	if (entities == nullptr) return;
+
+	UnloadLevel();
+
+	// Now that entities no longer keep each other alive, they must be cleaned
+	// up (eg. to stop the game manager's threads) before being destroyed
+	entities->Clear();
+}
 
 void ProcessInput() {
 	while (SDL_PollEvent(&Engine::Instance()->event) > 0) {
@@ -89,17 +105,15 @@ void ProcessInput() {
 							!Engine::Instance()->doInterpolation;
 						break;
 
+					case SDL_SCANCODE_P:
+						Engine::Instance()->ReportFrameStats();
+						break;
+
 					default:
 						break;
 				}
 
-				Engine::Instance()->GetInput()->SetKeyDown(
-					Engine::Instance()->event.key.keysym.scancode);
-				break;
-
-			case SDL_KEYUP:
-				Engine::Instance()->GetInput()->SetKeyUp(
-					Engine::Instance()->event.key.keysym.scancode);
+				// Key states are captured by the input's event watch
 				break;
 
 			case SDL_MOUSEWHEEL:
@@ -116,26 +130,13 @@ void ProcessInput() {
 	// SDL_GetMouseState(&mouseX, &mouseY);
 }
 
-void SetLastPositions() {
-	for (size_t i = 0; i < Engine::Instance()->GetAllActiveEntities().size();
-		 ++i) {
-		auto &entity = Engine::Instance()->GetAllActiveEntities()[i];
-		if (!entity->CanBeUsed()) continue;
-		entity->lastPos = entity->aabb.pos;
-	}
-}
-
 void PreFixedUpdate() {
 	for (auto collection : Engine::Instance()->GetEntityCollections()) {
 		collection->ProcessRemoveQueue();
 		collection->ProcessAddQueue();
 	}
 
-	// clang-format off
 	EntityFunctionCall(PreFixedUpdate)
-
-	SetLastPositions();
-	// clang-format on
 }
 
 void FixedUpdate() {
@@ -154,7 +155,15 @@ void Update() {
 	// clang-format on
 }
 
-void Render() { EntityFunctionCall(Render) }
+void Render() {
+	// Only visit the renderables within the camera's view
+	auto camera = Engine::Instance()->GetCamera();
+	for (auto *renderable : Engine::Instance()->GetRenderableGrid()->Query(
+			 camera->GetEntity()->visualAABB)) {
+		if (!renderable->GetEntity()->CanBeUsed()) continue;
+		renderable->Render();
+	}
+}
 
 void SubmitRender() {
 	// SDL_SetRenderDrawColor(Engine::Instance()->renderer, 247, 244,
@@ -164,7 +173,10 @@ void SubmitRender() {
 	Engine::Instance()->ExecuteRenderOps();
 
 	// Swap buffer for presentation
-	SDL_RenderPresent(Engine::Instance()->renderer);
+	{
+		PROFILE_SCOPE("SDL_RenderPresent");
+		SDL_RenderPresent(Engine::Instance()->renderer);
+	}
 }
 
 void Idling() {
@@ -174,36 +186,59 @@ void Idling() {
 }
 
 void CreateBarrier(Vec2 pos, Vec2 halfSize) {
-	auto barrierEntity = std::make_shared<Entity>(pos, halfSize);
-	barrierEntity->AddComponent(std::make_shared<StaticBody>(0b00000010));
-	barrierEntity->AddComponent(std::make_shared<RenderRect>(
+	auto world = Engine::Instance()->GetWorldArena();
+
+	auto barrierEntity = world->Create<Entity>(pos, halfSize);
+	barrierEntity->SetStatic(true);
+	barrierEntity->AddComponent(world->Create<StaticBody>(0b00000010));
+	barrierEntity->AddComponent(world->Create<RenderRect>(
 		RenderMode::FillOnly, Color::SetAlpha(Color::VividPink, 127),
 		Color::VividPink));
 
-	entities->Add(std::move(barrierEntity));
+	levelEntities->Add(std::move(barrierEntity));
 }
 
-void CreateObstacle(Vec2 pos, Vec2 halfSize) {
-	auto obstacleEntity = std::make_shared<Entity>(pos, halfSize);
-	obstacleEntity->AddComponent(std::make_shared<StaticBody>(0b00000010));
-	obstacleEntity->AddComponent(std::make_shared<RenderRect>(
-		RenderMode::FillOnly, Color::SetAlpha(Color::Orange, 127),
-		Color::Orange));
-
-	entities->Add(std::move(obstacleEntity));
+// Tile types used by levels, indexed by 'LevelTile'
+enum LevelTile : uint8_t {
+	Empty = TileMap::EmptyTile,
+	Grid,
+	Obstacle,
+	Barrier,
+};
+
+std::vector<TileType> CreateLevelTileTypes() {
+	return {
+		// Empty
+		{RenderMode::None, Color::White, Color::White, 0},
+		// Grid
+		{RenderMode::OutlineOnly, Color::White,
+		 Color::SetAlpha(Color::White, 31), 0},
+		// Obstacle
+		{RenderMode::FillOnly, Color::SetAlpha(Color::Orange, 127),
+		 Color::Orange, 0b00000010},
+		// Barrier
+		{RenderMode::FillOnly, Color::SetAlpha(Color::VividPink, 127),
+		 Color::VividPink, 0b00000010},
+	};
 }
 
-void CreateGrid(Vec2 pos, Vec2 halfSize) {
-	auto gridEntity = std::make_shared<Entity>(pos, halfSize);
-	gridEntity->AddComponent(
-		std::make_shared<RenderRect>(RenderMode::OutlineOnly, Color::White,
-									 Color::SetAlpha(Color::White, 31)));
-
-	entities->Add(std::move(gridEntity));
+uint8_t GetLevelTile(char c) {
+	switch (c) {
+		case '.':
+			return LevelTile::Grid;
+		case 'o':
+			return LevelTile::Obstacle;
+		case 'b':
+			return LevelTile::Barrier;
+		default:
+			return LevelTile::Empty;
+	}
 }
 
-bool LoadLevel(std::string path) {
-	std::ifstream levelFile(path);
+// Reads a text level, where each line is a row of tiles (see 'GetLevelTile()')
+// with the width taken from the first, and the file ends with a '!'
+bool ReadTextLevel(const std::string &path, LevelData &level) {
+	std::ifstream levelFile(path, std::ios::binary);
 
 	if (!levelFile.is_open()) {
 		// Couldn't open file?
@@ -211,55 +246,70 @@ bool LoadLevel(std::string path) {
 		return false;
 	}
 
-	Vec2 dimensions;
-	bool isFirstLine = true;
-	int lastChar = ' ';
-	std::vector<std::vector<char>> fileData;
-	fileData.push_back(std::vector<char>());
-	while (levelFile) {
-		int c = levelFile.get();
-		if (c == -1) break;
-
-		if (c != '\n') {
-			if (isFirstLine) dimensions.x++;
-
-			fileData[dimensions.y].push_back(c);
-		} else {
-			dimensions.y++;
-			fileData.push_back(std::vector<char>());
-			isFirstLine = false;
-		}
-
-		lastChar = c;
-	}
+	std::string fileData((std::istreambuf_iterator<char>(levelFile)),
+						 std::istreambuf_iterator<char>());
 
-	if (lastChar != '!') {
+	if (fileData.find('\n') == std::string::npos || fileData.back() != '!') {
 		// File didn't end correctly
 		std::cerr << "Level file ('" << path << "'), didn't end correctly!"
 				  << std::endl;
 		return false;
 	}
 
-	constexpr double HalfUnitSize = Config::UnitSize / 2.0;
-	const Vec2 scaledDimensions = dimensions * Config::UnitSize;
+	level.width = fileData.find('\n');
+	level.height = std::count(fileData.begin(), fileData.end(), '\n');
+	level.tileTypes = CreateLevelTileTypes();
+
+	level.tiles.assign(level.width * level.height, LevelTile::Empty);
+	size_t lineStart = 0;
+	for (int y = 0; y < level.height; ++y) {
+		size_t lineEnd = fileData.find('\n', lineStart);
+		int lineLength = std::min((int)(lineEnd - lineStart), level.width);
+
+		for (int x = 0; x < lineLength; ++x) {
+			level.tiles[y * level.width + x] =
+				GetLevelTile(fileData[lineStart + x]);
+		}
+
+		lineStart = lineEnd + 1;
+	}
+
+	return true;
+}
+
+bool IsBinaryLevel(const std::string &path) {
+	constexpr std::string_view extension = ".lvl";
+	return path.size() >= extension.size() &&
+		   path.compare(path.size() - extension.size(), extension.size(),
+						extension) == 0;
+}
+
+bool LoadLevel(std::string path) {
+	LevelData level;
+	if (IsBinaryLevel(path) ? !LevelFile::Read(path, level)
+							: !ReadTextLevel(path, level)) {
+		return false;
+	}
+
+	const Vec2 scaledDimensions =
+		Vec2(level.width, level.height) * Config::UnitSize;
 	const Vec2 halfScaledDimensions = scaledDimensions / 2.0;
-	const Vec2 posOffset = (scaledDimensions - Config::UnitSize) / 2.0;
+
+	auto world = Engine::Instance()->GetWorldArena();
 
 	// Fill level
-	for (int x = 0; x < dimensions.x; ++x) {
-		for (int y = 0; y < dimensions.y; ++y) {
-			Vec2 pos =
-				(((Vec2(x, y) / dimensions) * 2) - 1) * halfScaledDimensions +
-				HalfUnitSize;
-			if (fileData[y][x] == 'b') {
-				CreateBarrier(pos, Vec2(HalfUnitSize));
-			} else if (fileData[y][x] == 'o') {
-				CreateObstacle(pos, Vec2(HalfUnitSize));
-			} else if (fileData[y][x] == '.') {
-				CreateGrid(pos, Vec2(HalfUnitSize));
-			}
-		}
+	auto tileMapEntity = world->Create<Entity>(Vec2(), halfScaledDimensions);
+	tileMapEntity->SetStatic(true);
+	auto tileMap = world->Create<TileMap>(
+		level.width, level.height, Config::UnitSize, std::move(level.tileTypes),
+		std::move(level.tiles));
+	// Otherwise they're merged when the tile map is setup
+	if (level.chunkSize == Config::LevelChunkSize) {
+		tileMap->SetColliders(level.colliders, level.chunkOffsets);
 	}
+	tileMapEntity->AddComponent(std::move(tileMap));
+
+	levelEntities->Add(std::move(tileMapEntity));
 
 	constexpr float borderThickness =
 		std::max(Config::ScreenWidth, Config::ScreenHeight);
@@ -282,4 +332,25 @@ bool LoadLevel(std::string path) {
 
 	return true;
 }
+
+void UnloadLevel() {
+	// Everything must be cleaned up straight away, before the arena is reset
+	ASSERT(Engine::Instance()->CanAddOrRemoveEntities());
+
+	levelEntities->Clear();
+	Engine::Instance()->GetWorldArena()->Reset();
+}
+
+bool ConvertLevel(const std::string &textPath, const std::string &levelPath) {
+	LevelData level;
+	if (!ReadTextLevel(textPath, level)) return false;
+
+	LevelFile::MergeColliders(level, Config::LevelChunkSize);
+	if (!LevelFile::Write(levelPath, level)) return false;
+
+	std::cout << "Converted '" << textPath << "' (" << level.width << 'x'
+			  << level.height << ", " << level.colliders.size()
+			  << " colliders) to '" << levelPath << "'" << std::endl;
+	return true;
+}
 }  // namespace Game
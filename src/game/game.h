@@ -19,5 +19,12 @@ void Render();
 void SubmitRender();
 void Idling();
 
+// Level entities + components are allocated from the engine's world arena into
+// their own collection, so unloading can release them all at once
 bool LoadLevel(std::string path);
+void UnloadLevel();
+
+// Compiles a text level into the binary format loaded from '.lvl' files (see
+// 'level_file.h')
+bool ConvertLevel(const std::string &textPath, const std::string &levelPath);
 }  // namespace Game
\ No newline at end of file
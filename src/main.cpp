@@ -21,8 +21,10 @@ int main(int argc, char* argv[]) {
 
 	Engine::Instance()->idling = &Game::Idling;
 
+	Engine::Instance()->convertLevel = &Game::ConvertLevel;
+
 	Engine::Instance()->Run();
 	Engine::Instance()->Cleanup();
 
-	return 0;
+	return Engine::Instance()->GetExitCode();
 }
\ No newline at end of file